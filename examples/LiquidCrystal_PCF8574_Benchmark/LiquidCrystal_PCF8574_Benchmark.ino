@@ -0,0 +1,122 @@
+// Benchmark sketch for the LiquidCrystal_PCF8574 library.
+//
+// Measures the cost of the most common operations on the target and reports them
+// as CPU cycles on the Serial port:
+// * one character written by write(uint8_t)
+// * one character written as part of a longer print() run
+// * one setCursor() call
+// * one complete repaint of all rows of the display
+//
+// The numbers include the time spent blocking in the Wire library, so they depend on the I2C clock.
+// The sketch runs without a display as long as a device ACKs the address,
+// e.g. on an ATmega328 under simavr with a TWI peripheral model that ACKs the PCF8574 address.
+//
+// On the target the cycles are calculated from micros(), which has a resolution of 4 us on a 16 MHz AVR.
+// Every measurement is also marked in the GPIOR registers: extras/simavr/lcd_bench counts the exact
+// CPU cycles of the marked sections and reports these instead.
+
+#include <LiquidCrystal_PCF8574.h>
+#include <Wire.h>
+
+#define LCD_ADDR 0x27
+#define LCD_COLS 20
+#define LCD_ROWS 4
+#define ROUNDS 50
+
+LiquidCrystal_PCF8574 lcd(LCD_ADDR);
+
+// start a measured section: writing a value other than 0 to GPIOR0 starts the cycle counter of lcd_bench.
+// The serial output is sent before, so its interrupts are not counted.
+unsigned long markStart()
+{
+  Serial.flush();
+#if defined(GPIOR0)
+  GPIOR0 = 1;
+#endif
+  return micros();
+} // markStart()
+
+
+// end a measured section: the number of operations goes to GPIOR2:GPIOR1, writing 0 to GPIOR0 stops the counter.
+unsigned long markEnd(unsigned int ops)
+{
+  unsigned long now = micros();
+#if defined(GPIOR0)
+  GPIOR1 = ops & 0xFF;
+  GPIOR2 = ops >> 8;
+  GPIOR0 = 0;
+#else
+  (void)ops;
+#endif
+  return now;
+} // markEnd()
+
+
+// print the cycles per operation for a measured duration in microseconds.
+void report(const char *name, unsigned long us, unsigned long ops)
+{
+  unsigned long cycles = (us * (F_CPU / 1000000UL)) / ops;
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(cycles);
+  Serial.print(" cycles, ");
+  Serial.print(us / ops);
+  Serial.println(" us");
+} // report()
+
+
+void setup()
+{
+  char line[LCD_COLS + 1];
+  unsigned long start;
+
+  Serial.begin(115200);
+  Serial.println("LCD benchmark...");
+
+  Wire.begin();
+  Wire.setClock(100000);
+
+  lcd.begin(LCD_COLS, LCD_ROWS);
+  lcd.setBacklight(255);
+
+  memset(line, 'x', LCD_COLS);
+  line[LCD_COLS] = '\0';
+
+  // single characters
+  start = markStart();
+  for (int n = 0; n < ROUNDS * LCD_COLS; n++) {
+    lcd.write('a');
+  }
+  report("write(char)", markEnd(ROUNDS * LCD_COLS) - start, ROUNDS * LCD_COLS);
+
+  // characters in a run
+  start = markStart();
+  for (int n = 0; n < ROUNDS; n++) {
+    lcd.print(line);
+  }
+  report("print(run) per char", markEnd(ROUNDS * LCD_COLS) - start, ROUNDS * LCD_COLS);
+
+  // setCursor
+  start = markStart();
+  for (int n = 0; n < ROUNDS * LCD_ROWS; n++) {
+    lcd.setCursor(n % LCD_COLS, n % LCD_ROWS);
+  }
+  report("setCursor", markEnd(ROUNDS * LCD_ROWS) - start, ROUNDS * LCD_ROWS);
+
+  // full screen repaint
+  start = markStart();
+  for (int n = 0; n < ROUNDS; n++) {
+    for (int r = 0; r < LCD_ROWS; r++) {
+      lcd.setCursor(0, r);
+      lcd.print(line);
+    }
+  }
+  report("repaint", markEnd(ROUNDS) - start, ROUNDS);
+
+  Serial.println("done.");
+} // setup()
+
+
+void loop()
+{
+} // loop()
@@ -0,0 +1,66 @@
+// Example for the ESP32: the screens are composed in loop() on the application core,
+// all I2C traffic to the display is done by a task on the other core.
+//
+// The two sides exchange complete frames through a LiquidCrystal_PCF8574_Exchange.
+// loop() never waits for the display; when it publishes faster than the display
+// can follow, intermediate frames are dropped. A frame is only published when its text changed
+// and at most every 100 msec, faster than the liquid crystal can follow anyway.
+
+#include <LiquidCrystal_PCF8574.h>
+#include <LiquidCrystal_PCF8574_Exchange.h>
+#include <Wire.h>
+
+#define COLS 16
+#define ROWS 2
+#define FRAME_TIME 100 // msec between two frames
+
+LiquidCrystal_PCF8574 lcd(0x27); // set the LCD address to 0x27 for a 16 chars and 2 line display
+
+uint8_t frames[LCD_EXCHANGE_SIZE(COLS, ROWS)];
+LiquidCrystal_PCF8574_Exchange exchange(lcd, COLS, ROWS, frames);
+
+
+void render(void *)
+{
+  Wire.begin();
+  lcd.begin(COLS, ROWS);
+  lcd.setBacklight(255);
+
+  for (;;) {
+    if (!exchange.flush())
+      vTaskDelay(1);
+  }
+} // render()
+
+
+void setup()
+{
+  xTaskCreatePinnedToCore(render, "lcd", 4096, NULL, 1, NULL, 1 - xPortGetCoreID());
+} // setup()
+
+
+void loop()
+{
+  static unsigned long lastFrame;
+  static unsigned long counter;
+  char text[COLS + 1];
+  uint8_t *frame = exchange.frame();
+  bool changed = false;
+
+  // the application does its work in every loop
+  counter++;
+
+  if (millis() - lastFrame < FRAME_TIME)
+    return;
+  lastFrame = millis();
+
+  // the frame keeps the content of the last published frame
+  snprintf(text, sizeof(text), "Uptime  %-8lu", millis() / 1000);
+  changed |= (memcmp(frame, text, COLS) != 0);
+  memcpy(frame, text, COLS);
+  snprintf(text, sizeof(text), "Loops   %-8lu", counter);
+  changed |= (memcmp(frame + COLS, text, COLS) != 0);
+  memcpy(frame + COLS, text, COLS);
+  if (changed)
+    exchange.publish();
+} // loop()
@@ -0,0 +1,184 @@
+// Benchmark sketch for many displays on one I2C bus.
+//
+// Drives 1, 2, 4, 8 and 16 displays with a mixed workload of field updates,
+// periodic clears and CGRAM animations and reports for every number of displays:
+// * the time of begin()
+// * the number of field updates per second for all displays
+// * the maximum and average time between two updates of the same display
+// * the 50th, 95th and 99th percentile of the update latency: the time from the start of a round
+//   until the new value was sent to a display
+// * the share of the time the bus was busy with the updates and the share spent in fixed waits
+//
+// Every measurement is done with the sequential functions (one display after the other)
+// and with the group functions that wait only once for all displays.
+//
+// The displays use the addresses 0x20-0x27 (PCF8574) and 0x38-0x3F (PCF8574A).
+
+#include <LiquidCrystal_PCF8574.h>
+#include <Wire.h>
+
+#define MAX_DISPLAYS 16
+#define DURATION 3000 // msec per measurement
+#define BUCKETS 128 // latency histogram: 8 buckets per power of 2 up to 250 msec
+
+LiquidCrystal_PCF8574 lcds[MAX_DISPLAYS] = {
+  LiquidCrystal_PCF8574(0x20), LiquidCrystal_PCF8574(0x21), LiquidCrystal_PCF8574(0x22), LiquidCrystal_PCF8574(0x23),
+  LiquidCrystal_PCF8574(0x24), LiquidCrystal_PCF8574(0x25), LiquidCrystal_PCF8574(0x26), LiquidCrystal_PCF8574(0x27),
+  LiquidCrystal_PCF8574(0x38), LiquidCrystal_PCF8574(0x39), LiquidCrystal_PCF8574(0x3A), LiquidCrystal_PCF8574(0x3B),
+  LiquidCrystal_PCF8574(0x3C), LiquidCrystal_PCF8574(0x3D), LiquidCrystal_PCF8574(0x3E), LiquidCrystal_PCF8574(0x3F)
+};
+
+LiquidCrystal_PCF8574 *displays[MAX_DISPLAYS];
+
+byte bar[8] = { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F };
+
+// The latencies are counted in buckets with a resolution of 1/8 of their magnitude
+// so the percentiles can be computed without storing every value.
+unsigned long histogram[BUCKETS];
+
+
+uint8_t bucket(unsigned long us)
+{
+  uint8_t e = 3;
+  if (us < 8)
+    return us;
+  while ((us >> (e - 3)) >= 16)
+    e++;
+  unsigned long b = 8 + (e - 3) * 8 + ((us >> (e - 3)) & 7);
+  return (b < BUCKETS) ? b : BUCKETS - 1;
+} // bucket()
+
+
+// the largest latency counted in bucket b.
+unsigned long bucketLimit(uint8_t b)
+{
+  b++;
+  if (b < 8)
+    return b - 1;
+  return ((8UL + (b - 8) % 8) << ((b - 8) / 8)) - 1;
+} // bucketLimit()
+
+
+// the latency that is not exceeded by the given per mill of the updates.
+unsigned long percentile(unsigned long count, unsigned int perMill)
+{
+  unsigned long limit = (count * perMill + 999) / 1000;
+  unsigned long sum = 0;
+  for (uint8_t b = 0; b < BUCKETS; b++) {
+    sum += histogram[b];
+    if (sum >= limit)
+      return bucketLimit(b);
+  }
+  return bucketLimit(BUCKETS - 1);
+} // percentile()
+
+
+void run(uint8_t count, bool group)
+{
+  unsigned long start, elapsed, lastUpdate[MAX_DISPLAYS];
+  unsigned long maxGap = 0, sumGap = 0, waits = 0, busy = 0;
+  unsigned long updates = 0;
+  char text[8];
+
+  // initialization
+  start = millis();
+  if (group) {
+    LiquidCrystal_PCF8574::begin(displays, count, 16, 2);
+  } else {
+    for (uint8_t n = 0; n < count; n++)
+      displays[n]->begin(16, 2);
+  }
+  unsigned long beginTime = millis() - start;
+
+  memset(histogram, 0, sizeof(histogram));
+  start = millis();
+  for (uint8_t n = 0; n < count; n++)
+    lastUpdate[n] = micros();
+
+  for (unsigned long round = 0; millis() - start < DURATION; round++) {
+    // periodic clear of all displays
+    if (round % 50 == 49) {
+      unsigned long t = micros();
+      if (group) {
+        LiquidCrystal_PCF8574::clear(displays, count);
+      } else {
+        for (uint8_t n = 0; n < count; n++)
+          displays[n]->clear();
+      }
+      waits += micros() - t;
+    }
+
+    unsigned long roundStart = micros();
+    for (uint8_t n = 0; n < count; n++) {
+      LiquidCrystal_PCF8574 *lcd = displays[n];
+      unsigned long t = micros();
+
+      // CGRAM animation
+      if (round % 10 == n % 10) {
+        bar[round % 8] ^= 0x1F;
+        lcd->createChar(0, bar);
+      }
+
+      // field update
+      snprintf(text, sizeof(text), "%6lu", round);
+      lcd->writeAt(0, n & 1, (const uint8_t *)text, 6);
+      lcd->writeAt(7, n & 1, (const uint8_t *)"\0", 1);
+
+      unsigned long now = micros();
+      busy += now - t;
+      histogram[bucket(now - roundStart)]++;
+      unsigned long gap = now - lastUpdate[n];
+      lastUpdate[n] = now;
+      if (gap > maxGap) maxGap = gap;
+      sumGap += gap;
+      updates++;
+    }
+  }
+  elapsed = millis() - start;
+
+  Serial.print(count);
+  Serial.print(group ? " group " : " single");
+  Serial.print("  begin ");
+  Serial.print(beginTime);
+  Serial.print(" ms, ");
+  Serial.print(updates * 1000 / elapsed);
+  Serial.print(" updates/s, gap avg ");
+  Serial.print(sumGap / updates);
+  Serial.print(" us, max ");
+  Serial.print(maxGap);
+  Serial.print(" us, latency p50 ");
+  Serial.print(percentile(updates, 500));
+  Serial.print(" p95 ");
+  Serial.print(percentile(updates, 950));
+  Serial.print(" p99 ");
+  Serial.print(percentile(updates, 990));
+  Serial.print(" us, bus busy ");
+  Serial.print(busy / 10 / elapsed);
+  Serial.print(" %, waiting ");
+  Serial.print(waits / 10 / elapsed);
+  Serial.println(" %");
+} // run()
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("Multi display benchmark...");
+
+  Wire.begin();
+  Wire.setClock(400000);
+
+  for (uint8_t n = 0; n < MAX_DISPLAYS; n++)
+    displays[n] = &lcds[n];
+
+  for (uint8_t count = 1; count <= MAX_DISPLAYS; count *= 2) {
+    run(count, false);
+    run(count, true);
+  }
+  Serial.println("done.");
+} // setup()
+
+
+void loop()
+{
+} // loop()
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""Footprint report for the library under a matrix of feature configurations.
+
+Every sketch in sketches/ uses one feature set of the library. The sketches are compiled
+with arduino-cli and -fstack-usage for every board that has its core installed.
+The report contains per configuration and board:
+
+  * flash (text + data) and static RAM (data + bss) of the sketch
+  * sizeof() of the classes of the configuration (sketch symbols named sizeof_<class>)
+  * the stack frame of every public function of the library (from the .su files,
+    without the frames of called functions)
+
+usage:
+  footprint.py                          print the report
+  footprint.py --baseline base.json     fail when flash or RAM grew compared to the baseline
+  footprint.py --baseline base.json --update
+                                        write the current numbers as new baseline
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(os.path.dirname(HERE))
+
+# board, tool prefix of the compiler
+BOARDS = [
+    ('arduino:avr:uno', 'avr-'),
+    ('arduino:samd:mkrzero', 'arm-none-eabi-'),
+    ('esp8266:esp8266:generic', 'xtensa-lx106-elf-'),
+]
+
+
+def installed_cores():
+    try:
+        out = subprocess.run(['arduino-cli', 'core', 'list', '--format', 'json'],
+                             capture_output=True, text=True, check=True).stdout
+    except (OSError, subprocess.CalledProcessError):
+        return set()
+    data = json.loads(out or '[]')
+    if isinstance(data, dict):
+        data = data.get('platforms', [])
+    return set(p.get('id', '') for p in data)
+
+
+def find_tool(name):
+    """The binutils of the toolchain that arduino-cli used."""
+    for path in glob.glob(os.path.expanduser('~/.arduino15/packages/*/tools/*/*/bin/' + name)):
+        return path
+    return shutil.which(name)
+
+
+def compile_sketch(sketch, fqbn, build):
+    cmd = ['arduino-cli', 'compile', '--fqbn', fqbn, '--library', ROOT, '--build-path', build,
+           '--build-property', 'compiler.cpp.extra_flags=-fstack-usage', sketch]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout + result.stderr)
+        return None
+    elfs = glob.glob(os.path.join(build, '*.elf'))
+    return elfs[0] if elfs else None
+
+
+def sizes(elf, prefix):
+    out = subprocess.run([find_tool(prefix + 'size') or prefix + 'size', '-A', elf],
+                         capture_output=True, text=True, check=True).stdout
+    sec = {}
+    for line in out.splitlines():
+        m = re.match(r'^(\.\S+)\s+(\d+)', line)
+        if m:
+            sec[m.group(1)] = int(m.group(2))
+    text = sec.get('.text', 0) + sec.get('.irom0.text', 0) + sec.get('.rodata', 0)
+    data = sec.get('.data', 0)
+    bss = sec.get('.bss', 0)
+    return text + data, data + bss
+
+
+def class_sizes(elf, prefix):
+    out = subprocess.run([find_tool(prefix + 'nm') or prefix + 'nm', '-S', '-C', elf],
+                         capture_output=True, text=True, check=True).stdout
+    result = {}
+    for line in out.splitlines():
+        m = re.match(r'^[0-9a-f]+\s+([0-9a-f]+)\s+\w\s+sizeof_(\w+)$', line)
+        if m:
+            result[m.group(2)] = int(m.group(1), 16)
+    return result
+
+
+def parse_su_line(line):
+    """Function and stack frame size of a line of a .su file, None for other lines.
+
+    A line is 'file:line:column:function<TAB>size<TAB>qualifiers', the function contains colons itself.
+    """
+    parts = line.rstrip('\r\n').split('\t')
+    if len(parts) < 3:
+        return None
+    location = parts[0]
+    if re.match(r'[A-Za-z]:[\\/]', location):
+        # windows drive letter
+        location = location[2:]
+    fields = location.split(':', 3)
+    if len(fields) < 4 or not parts[1].isdigit():
+        return None
+    return fields[3], int(parts[1])
+
+
+def stack_frames(build):
+    """Stack frames of the library functions from the .su files."""
+    result = {}
+    for su in glob.glob(os.path.join(build, 'libraries', '**', '*.su'), recursive=True):
+        with open(su) as f:
+            for line in f:
+                frame = parse_su_line(line)
+                if not frame:
+                    continue
+                name, size = frame
+                if 'LiquidCrystal_PCF8574' in name and '::_' not in name:
+                    result[name] = max(result.get(name, 0), size)
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--baseline', help='json file with the numbers to compare with')
+    parser.add_argument('--update', action='store_true', help='write the baseline')
+    parser.add_argument('--stack', action='store_true', help='list the stack frames of the public functions')
+    args = parser.parse_args()
+
+    if not shutil.which('arduino-cli'):
+        print('arduino-cli not found', file=sys.stderr)
+        return 2
+    cores = installed_cores()
+    boards = [(fqbn, prefix) for fqbn, prefix in BOARDS if ':'.join(fqbn.split(':')[:2]) in cores]
+    if not boards:
+        print('no supported core installed', file=sys.stderr)
+        return 2
+
+    sketches = sorted(glob.glob(os.path.join(HERE, 'sketches', '*')))
+    report = {}
+    frames = {}
+    with tempfile.TemporaryDirectory() as tmp:
+        for fqbn, prefix in boards:
+            for sketch in sketches:
+                name = os.path.basename(sketch)
+                build = os.path.join(tmp, fqbn.replace(':', '_'), name)
+                elf = compile_sketch(sketch, fqbn, build)
+                if not elf:
+                    print('%s %s: compile failed' % (fqbn, name), file=sys.stderr)
+                    return 1
+                flash, ram = sizes(elf, prefix)
+                report['%s %s' % (fqbn, name)] = dict(flash=flash, ram=ram, sizeof=class_sizes(elf, prefix))
+                for func, size in stack_frames(build).items():
+                    key = '%s %s' % (fqbn, func)
+                    frames[key] = max(frames.get(key, 0), size)
+
+    print('| board | configuration | flash | static RAM | sizeof |')
+    print('|---|---|---:|---:|---|')
+    for key in sorted(report):
+        fqbn, name = key.split(' ')
+        r = report[key]
+        classes = ', '.join('%s %d' % (c.replace('LiquidCrystal_PCF8574', 'LCD'), s) for c, s in sorted(r['sizeof'].items()))
+        print('| %s | %s | %d | %d | %s |' % (fqbn, name, r['flash'], r['ram'], classes))
+
+    if args.stack:
+        print()
+        print('| board | function | stack frame |')
+        print('|---|---|---:|')
+        for key in sorted(frames):
+            fqbn, func = key.split(' ', 1)
+            print('| %s | %s | %d |' % (fqbn, func, frames[key]))
+
+    if args.baseline:
+        if args.update:
+            with open(args.baseline, 'w') as f:
+                json.dump(report, f, indent=2, sort_keys=True)
+            return 0
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        failed = False
+        for key, r in sorted(report.items()):
+            base = baseline.get(key)
+            if not base:
+                continue
+            for what in ('flash', 'ram'):
+                if r[what] > base[what]:
+                    print('%s: %s grew from %d to %d bytes' % (key, what, base[what], r[what]), file=sys.stderr)
+                    failed = True
+        return 1 if failed else 0
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,17 @@
+// footprint: the display class with print()
+#include <LiquidCrystal_PCF8574.h>
+
+LiquidCrystal_PCF8574 lcd(0x27);
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574[sizeof(LiquidCrystal_PCF8574)];
+
+void setup()
+{
+  lcd.begin(16, 2);
+  lcd.setBacklight(255);
+  lcd.setCursor(0, 1);
+  lcd.print("Hello");
+}
+
+void loop()
+{
+}
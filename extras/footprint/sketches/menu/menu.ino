@@ -0,0 +1,21 @@
+// footprint: menu with 3 items
+#include <LiquidCrystal_PCF8574_Menu.h>
+
+LiquidCrystal_PCF8574 lcd(0x27);
+const char item0[] PROGMEM = "Settings";
+const char item1[] PROGMEM = "Information";
+const char item2[] PROGMEM = "Exit";
+const char *const items[] PROGMEM = { item0, item1, item2 };
+LiquidCrystal_PCF8574_Menu menu(lcd, items, 3, 16, 2);
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574_Menu[sizeof(LiquidCrystal_PCF8574_Menu)];
+
+void setup()
+{
+  lcd.begin(16, 2);
+  menu.draw();
+}
+
+void loop()
+{
+  menu.next();
+}
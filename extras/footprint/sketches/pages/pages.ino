@@ -0,0 +1,17 @@
+// footprint: writeAt() and pages
+#include <LiquidCrystal_PCF8574.h>
+
+LiquidCrystal_PCF8574 lcd(0x27);
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574[sizeof(LiquidCrystal_PCF8574)];
+
+void setup()
+{
+  lcd.begin(16, 2);
+  lcd.writePage(1, 0, 0, (const uint8_t *)"Hello", 5);
+  lcd.showPage(1);
+  lcd.writeAt(0, 1, (const uint8_t *)"World", 5);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,20 @@
+// footprint: frame player with a 32 byte buffer
+#include <LiquidCrystal_PCF8574_Player.h>
+
+LiquidCrystal_PCF8574 lcd(0x27);
+const uint8_t frames[] PROGMEM = { 'L', 'F', 16, 2, 1, 0, 100, 0, 0x02, 0, 2, 'H', 'i', 0x00 };
+uint8_t buffer[32];
+LiquidCrystal_PCF8574_Player player(lcd, buffer, sizeof(buffer));
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574_Player[sizeof(LiquidCrystal_PCF8574_Player)];
+
+void setup()
+{
+  lcd.begin(16, 2);
+  player.begin(frames, sizeof(frames));
+  player.setLoop(true);
+}
+
+void loop()
+{
+  player.update();
+}
@@ -0,0 +1,29 @@
+// footprint: screen template with 2 fields and latency statistics
+#include <LiquidCrystal_PCF8574_Screen.h>
+
+LiquidCrystal_PCF8574 lcd(0x27);
+int temp;
+long count;
+const char layout[] PROGMEM = "Temp:      C\nCount:";
+const LiquidCrystal_PCF8574_Field fields[] PROGMEM = {
+  { 6, 0, 5, LCD_FIELD_INT, 1, &temp, 0 },
+  { 7, 1, 8, LCD_FIELD_LONG, 0, &count, 0 }
+};
+char cache[13];
+LiquidCrystal_PCF8574_Latency stats[2];
+LiquidCrystal_PCF8574_Screen screen(lcd, layout, fields, 2, cache, sizeof(cache));
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574_Screen[sizeof(LiquidCrystal_PCF8574_Screen)];
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574_Latency[sizeof(LiquidCrystal_PCF8574_Latency)];
+
+void setup()
+{
+  lcd.begin(16, 2);
+  screen.setLatencyStats(stats);
+  screen.draw();
+}
+
+void loop()
+{
+  count++;
+  screen.refresh(8);
+}
@@ -0,0 +1,52 @@
+// footprint: classes with static storage, the same feature sets as screen, menu and player
+#include <LiquidCrystal_PCF8574_Static.h>
+
+LiquidCrystal_PCF8574 lcd(0x27);
+int temp;
+long count;
+const char layout[] PROGMEM = "Temp:      C\nCount:";
+const LiquidCrystal_PCF8574_Field fields[2] PROGMEM = {
+  { 6, 0, 5, LCD_FIELD_INT, 1, &temp, 0 },
+  { 7, 1, 8, LCD_FIELD_LONG, 0, &count, 0 }
+};
+const char item0[] PROGMEM = "Settings";
+const char item1[] PROGMEM = "Information";
+const char item2[] PROGMEM = "Exit";
+const char *const items[] PROGMEM = { item0, item1, item2 };
+const uint8_t frames[] PROGMEM = { 'L', 'F', 16, 2, 1, 0, 100, 0, 0x02, 0, 2, 'H', 'i', 0x00 };
+const uint8_t glyphs[2][8] PROGMEM = { { 0x1F }, { 0x0E } };
+
+LiquidCrystal_PCF8574_StaticScreen<2, 13, true> screen(lcd, layout, fields);
+LiquidCrystal_PCF8574_StaticMenu<16, 2> menu(lcd, items, 3);
+LiquidCrystal_PCF8574_StaticPlayer<32, 16> player(lcd);
+LiquidCrystal_PCF8574_StaticGlyphs<2> cgram(lcd, glyphs);
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574_StaticScreen[sizeof(screen)];
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574_StaticMenu[sizeof(menu)];
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574_StaticPlayer[sizeof(player)];
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574_StaticGlyphs[sizeof(cgram)];
+#if !defined(__AVR__)
+LiquidCrystal_PCF8574_StaticExchange<16, 2> exchange(lcd);
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574_StaticExchange[sizeof(exchange)];
+#endif
+
+void setup()
+{
+  const uint8_t current[] = { 0, 1 };
+  lcd.begin(16, 2);
+  cgram.use(current, 2);
+  screen.draw();
+  menu.draw();
+  player.begin(frames, sizeof(frames));
+}
+
+void loop()
+{
+  count++;
+  screen.refresh(8);
+  menu.next();
+  player.update();
+#if !defined(__AVR__)
+  exchange.publish();
+  exchange.flush();
+#endif
+}
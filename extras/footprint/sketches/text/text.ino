@@ -0,0 +1,18 @@
+// footprint: compressed text store
+#include <LiquidCrystal_PCF8574_Text.h>
+
+LiquidCrystal_PCF8574 lcd(0x27);
+// one string "Hello" and an empty dictionary
+const uint8_t blob[] PROGMEM = { 1, 0, 12, 0, 6, 0, 5, 'H', 'e', 'l', 'l', 'o', 0 };
+LiquidCrystal_PCF8574_Text text(blob);
+__attribute__((used)) char sizeof_LiquidCrystal_PCF8574_Text[sizeof(LiquidCrystal_PCF8574_Text)];
+
+void setup()
+{
+  lcd.begin(16, 2);
+  text.show(lcd, 0);
+}
+
+void loop()
+{
+}
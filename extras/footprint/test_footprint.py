@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+"""Tests of the parts of footprint.py that do not need arduino-cli."""
+
+import os
+import tempfile
+import unittest
+
+import footprint
+
+# lines of .su files written by gcc -fstack-usage
+SETCURSOR = ('/home/user/Arduino/libraries/LiquidCrystal_PCF8574/src/LiquidCrystal_PCF8574.cpp:282:6:'
+             'void LiquidCrystal_PCF8574::setCursor(uint8_t, uint8_t)\t16\tstatic\n')
+IDLEPINS = ('/home/user/Arduino/libraries/LiquidCrystal_PCF8574/src/LiquidCrystal_PCF8574.h:204:18:'
+            'uint8_t LiquidCrystal_PCF8574::_idlePins()\t4\tstatic\n')
+CLEAR = ('/home/user/Arduino/libraries/LiquidCrystal_PCF8574/src/LiquidCrystal_PCF8574.cpp:330:6:'
+         'static void LiquidCrystal_PCF8574::clear(LiquidCrystal_PCF8574**, uint8_t)\t24\tdynamic,bounded\n')
+WINDOWS = ('C:\\Users\\user\\Arduino\\libraries\\LiquidCrystal_PCF8574\\src\\LiquidCrystal_PCF8574.cpp:282:6:'
+           'void LiquidCrystal_PCF8574::setCursor(uint8_t, uint8_t)\t16\tstatic\r\n')
+
+
+class ParseTest(unittest.TestCase):
+
+    def test_member_function(self):
+        self.assertEqual(footprint.parse_su_line(SETCURSOR),
+                         ('void LiquidCrystal_PCF8574::setCursor(uint8_t, uint8_t)', 16))
+
+    def test_windows_path(self):
+        self.assertEqual(footprint.parse_su_line(WINDOWS),
+                         ('void LiquidCrystal_PCF8574::setCursor(uint8_t, uint8_t)', 16))
+
+    def test_other_lines(self):
+        self.assertIsNone(footprint.parse_su_line(''))
+        self.assertIsNone(footprint.parse_su_line('no location\t16\tstatic\n'))
+
+    def test_stack_frames(self):
+        with tempfile.TemporaryDirectory() as build:
+            folder = os.path.join(build, 'libraries', 'LiquidCrystal_PCF8574')
+            os.makedirs(folder)
+            with open(os.path.join(folder, 'LiquidCrystal_PCF8574.cpp.su'), 'w') as f:
+                f.write(SETCURSOR + IDLEPINS + CLEAR)
+            self.assertEqual(footprint.stack_frames(build), {
+                'void LiquidCrystal_PCF8574::setCursor(uint8_t, uint8_t)': 16,
+                'static void LiquidCrystal_PCF8574::clear(LiquidCrystal_PCF8574**, uint8_t)': 24,
+            })
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+"""Create frame sequences for LiquidCrystal_PCF8574_Player from text frames.
+
+Input format (text):
+
+    # comment
+    size 16 2
+    period 100
+    glyph 0 0x00 0x0a 0x1f 0x1f 0x0e 0x04 0x00 0x00
+    frame
+    Hello World
+    \\0 first glyph
+    frame
+    ...
+
+A "frame" line is followed by one line per display row. Lines are padded with spaces.
+"\\0" .. "\\7" in a row are the characters of CGRAM slot 0..7.
+"glyph" lines define CGRAM slots that are loaded before the next frame is drawn.
+
+usage:
+    lcd_frames.py input.txt -o anim.bin            binary sequence (e.g. for a file on SD card)
+    lcd_frames.py input.txt -c anim -o anim.h      C header with a PROGMEM array
+    lcd_frames.py --show anim.bin                  decode a sequence and print its frames
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+REC_END = 0x00
+REC_GLYPH = 0x01
+REC_RUN = 0x02
+
+# gaps of up to this number of unchanged characters are sent within one run.
+MERGE_GAP = 2
+
+
+def parse(text):
+    cols, rows, period = 16, 2, 100
+    frames = []
+    glyphs = {}
+    current = None
+    for line in text.splitlines():
+        if current is not None and len(current[1]) < rows:
+            current[1].append(line)
+            continue
+        stripped = line.strip()
+        if not stripped or stripped.startswith('#'):
+            continue
+        words = stripped.split()
+        if words[0] == 'size':
+            cols, rows = int(words[1]), int(words[2])
+        elif words[0] == 'period':
+            period = int(words[1])
+        elif words[0] == 'glyph':
+            slot = int(words[1], 0)
+            data = [int(w, 0) & 0x1f for w in words[2:10]]
+            if not 0 <= slot <= 7 or len(data) != 8:
+                raise ValueError('glyph needs a slot 0..7 and 8 values: ' + line)
+            glyphs[slot] = data
+        elif words[0] == 'frame':
+            current = (glyphs, [])
+            frames.append(current)
+            glyphs = {}
+        else:
+            raise ValueError('unexpected line: ' + line)
+
+    result = []
+    for glyph_set, lines in frames:
+        lines = lines + [''] * (rows - len(lines))
+        screen = bytearray()
+        for line in lines:
+            data = re.sub(r'\\([0-7])', lambda m: chr(int(m.group(1))), line).encode('latin-1')
+            screen += data[:cols].ljust(cols, b' ')
+        result.append((glyph_set, screen))
+    return cols, rows, period, result
+
+
+def encode(cols, rows, period, frames):
+    if cols * rows > 256:
+        raise ValueError('display too large for 8 bit positions')
+    out = bytearray(b'LF' + bytes([cols, rows]) + struct.pack('<HH', len(frames), period))
+    previous = None
+    for glyph_set, screen in frames:
+        for slot in sorted(glyph_set):
+            out += bytes([REC_GLYPH, slot] + glyph_set[slot])
+        for row in range(rows):
+            base = row * cols
+            if previous is None:
+                # the first frame is complete so the sequence can be repeated
+                changed = list(range(cols))
+            else:
+                changed = [c for c in range(cols) if screen[base + c] != previous[base + c]]
+            runs = []
+            for c in changed:
+                if runs and c - runs[-1][1] <= MERGE_GAP + 1:
+                    runs[-1][1] = c
+                else:
+                    runs.append([c, c])
+            for start, end in runs:
+                out += bytes([REC_RUN, base + start, end - start + 1]) + screen[base + start:base + end + 1]
+        out.append(REC_END)
+        previous = screen
+    return bytes(out)
+
+
+def decode(data):
+    if data[:2] != b'LF':
+        raise ValueError('not a frame sequence')
+    cols, rows = data[2], data[3]
+    count, period = struct.unpack('<HH', data[4:8])
+    screen = bytearray(b' ' * (cols * rows))
+    frames = []
+    pos = 8
+    while pos < len(data):
+        glyphs = {}
+        while pos < len(data):
+            rec = data[pos]
+            if rec == REC_END:
+                pos += 1
+                break
+            elif rec == REC_GLYPH:
+                glyphs[data[pos + 1]] = list(data[pos + 2:pos + 10])
+                pos += 10
+            elif rec == REC_RUN:
+                start, length = data[pos + 1], data[pos + 2]
+                screen[start:start + length] = data[pos + 3:pos + 3 + length]
+                pos += 3 + length
+            else:
+                raise ValueError('unknown record 0x%02x at %d' % (rec, pos))
+        frames.append((glyphs, bytes(screen)))
+    return cols, rows, period, count, frames
+
+
+def c_header(name, data):
+    lines = ['// generated by lcd_frames.py', '#include <Arduino.h>', '',
+             'const uint8_t %s[] PROGMEM = {' % name]
+    for i in range(0, len(data), 16):
+        lines.append('  ' + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',')
+    lines.append('};')
+    lines.append('const size_t %s_size = sizeof(%s);' % (name, name))
+    return '\n'.join(lines) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input')
+    parser.add_argument('-o', '--output', help='output file (default: stdout)')
+    parser.add_argument('-c', '--c-array', metavar='NAME', help='write a C header with a PROGMEM array')
+    parser.add_argument('--show', action='store_true', help='decode a binary sequence and print the frames')
+    args = parser.parse_args()
+
+    if args.show:
+        with open(args.input, 'rb') as f:
+            cols, rows, period, count, frames = decode(f.read())
+        print('%d x %d, %d frames, %d msec' % (cols, rows, count, period))
+        for n, (glyphs, screen) in enumerate(frames):
+            print('frame %d %s' % (n, ' '.join('glyph %d' % g for g in sorted(glyphs))))
+            for r in range(rows):
+                row = screen[r * cols:(r + 1) * cols]
+                print('|' + ''.join(chr(c) if c >= 32 else '\\%d' % c for c in row) + '|')
+        return 0
+
+    with open(args.input) as f:
+        cols, rows, period, frames = parse(f.read())
+    data = encode(cols, rows, period, frames)
+
+    # verify the encoding
+    _, _, _, _, decoded = decode(data)
+    assert [s for _, s in decoded] == [bytes(s) for _, s in frames]
+
+    if args.c_array:
+        result = c_header(args.c_array, data).encode()
+    else:
+        result = data
+    if args.output:
+        with open(args.output, 'wb') as f:
+            f.write(result)
+    else:
+        sys.stdout.buffer.write(result)
+    print('%d frames, %d bytes' % (len(frames), len(data)), file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
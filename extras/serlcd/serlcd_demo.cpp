@@ -0,0 +1,72 @@
+// Host build of a sketch for a SerLCD backpack, writing to a serial device like the pty of serlcd_pty.py.
+//
+// The library is built with the Arduino stand-ins of extras/test. The program shows a text,
+// a counter and a bar of custom characters. serlcd_pty.py shows custom characters by their number,
+// so the final screen is:
+//
+//   |Hello SerLCD    |
+//   |Count 10 00000  |
+//
+// usage: serlcd_demo <device>
+
+#include <Arduino.h>
+#include <LiquidCrystal_PCF8574.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+/// Print to a file descriptor.
+class FilePrint : public Print
+{
+public:
+  FilePrint(int fd) : _fd(fd) {}
+
+  virtual size_t write(uint8_t c) { return write(&c, 1); }
+
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    ssize_t n = ::write(_fd, buffer, size);
+    return (n > 0) ? n : 0;
+  }
+
+private:
+  int _fd;
+};
+
+
+int main(int argc, char *argv[])
+{
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <device>\n", argv[0]);
+    return 2;
+  }
+  int fd = open(argv[1], O_WRONLY | O_NOCTTY);
+  if (fd < 0) {
+    perror(argv[1]);
+    return 2;
+  }
+
+  FilePrint serial(fd);
+  LiquidCrystal_PCF8574 lcd(serial);
+  byte bar[8] = { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F };
+  const uint8_t block = 0;
+
+  lcd.begin(16, 2);
+  lcd.setBacklight(255);
+  lcd.createChar(0, bar);
+  lcd.setCursor(0, 0);
+  lcd.print("Hello SerLCD");
+
+  for (int n = 1; n <= 10; n++) {
+    char text[9];
+    snprintf(text, sizeof(text), "Count %-2d", n);
+    lcd.writeAt(0, 1, (const uint8_t *)text, 8);
+    if (n % 2 == 0)
+      lcd.writeAt(8 + n / 2, 1, &block, 1);
+    usleep(100000);
+  }
+  lcd.cursor();
+
+  close(fd);
+  return 0;
+}
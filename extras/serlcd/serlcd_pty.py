@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""Stand-in for a SerLCD compatible backpack on a pseudo terminal.
+
+Creates a pty, prints the name of its device and shows the display content whenever the
+received byte stream pauses. A host build of a sketch that writes to this device (e.g. a Print
+class writing to the file, see serlcd_demo.cpp and the Makefile) can be checked without the backpack.
+With --timeout it exits when nothing was received for that many seconds.
+
+Supported commands:
+
+  0xFE <instruction>        HD44780 instruction: clear, home, entry mode, display control,
+                            cursor or display shift, set CGRAM / DDRAM address
+  '|' 128..157              backlight brightness
+  '|' 27..34 <8 bytes>      define custom character 0..7
+  '|' 35..42                show custom character 0..7
+  '|' '-'                   clear display
+  other bytes               characters at the cursor
+
+Usage:
+  serlcd_pty.py [--cols 16] [--rows 2] [--log FILE] [--timeout SECONDS]
+"""
+
+import argparse
+import os
+import select
+import sys
+import time
+import tty
+
+ROW_OFFSETS = [0x00, 0x40, 0x14, 0x54]
+
+
+class SerLCD:
+    def __init__(self, cols, rows):
+        self.cols = cols
+        self.rows = rows
+        self.ddram = [0x20] * 128
+        self.cgram = [[0] * 8 for _ in range(8)]
+        self.ac = 0
+        self.cg = False
+        self.increment = True
+        self.autoscroll = False
+        self.shift = 0
+        self.display = True
+        self.backlight = 29
+        self.pending = []  # bytes of an unfinished command
+
+    def _line_len(self):
+        return 80 if self.rows == 1 else 40
+
+    def _step(self, increment):
+        if self.cg:
+            self.ac = (self.ac + (1 if increment else -1)) & 0x3F
+        elif self.rows == 1:
+            self.ac = (self.ac + (1 if increment else -1)) % 80
+        else:
+            line = self.ac & 0x40
+            col = ((self.ac & 0x3F) + (1 if increment else -1))
+            if col >= 40:
+                line, col = line ^ 0x40, 0
+            elif col < 0:
+                line, col = line ^ 0x40, 39
+            self.ac = line | col
+
+    def instruction(self, v):
+        if v & 0x80:
+            self.ac, self.cg = v & 0x7F, False
+        elif v & 0x40:
+            self.ac, self.cg = v & 0x3F, True
+        elif v & 0x20:
+            pass  # function set, the backpack keeps its interface
+        elif v & 0x10:
+            if v & 0x08:
+                self.shift += 1 if v & 0x04 else -1
+            else:
+                self._step(bool(v & 0x04))
+        elif v & 0x08:
+            self.display = bool(v & 0x04)
+        elif v & 0x04:
+            self.increment, self.autoscroll = bool(v & 0x02), bool(v & 0x01)
+        elif v & 0x02:
+            self.ac, self.cg, self.shift = 0, False, 0
+        elif v & 0x01:
+            self.ddram = [0x20] * 128
+            self.ac, self.cg, self.shift, self.increment = 0, False, 0, True
+
+    def data(self, v):
+        if self.cg:
+            self.cgram[self.ac >> 3][self.ac & 7] = v
+        else:
+            self.ddram[self.ac] = v
+            if self.autoscroll:
+                self.shift += -1 if self.increment else 1
+        self._step(self.increment)
+
+    def feed(self, b):
+        p = self.pending
+        if p:
+            p.append(b)
+            if p[0] == 0xFE:
+                self.instruction(b)
+                p.clear()
+            elif len(p) == 2:
+                s = p[1]
+                if 27 <= s <= 34:
+                    return  # wait for the 8 bytes of the character
+                if 128 <= s <= 157:
+                    self.backlight = s - 128
+                elif 35 <= s <= 42:
+                    self.data(s - 35)
+                elif s == ord('-'):
+                    self.instruction(0x01)
+                p.clear()
+            elif len(p) == 10:
+                self.cgram[p[1] - 27] = p[2:]
+                p.clear()
+        elif b in (0xFE, 0x7C):
+            p.append(b)
+        else:
+            self.data(b)
+
+    def render(self):
+        out = []
+        for r in range(self.rows):
+            base = ROW_OFFSETS[r]
+            chars = []
+            for c in range(self.cols):
+                if self.rows == 1:
+                    a = (c - self.shift) % 80
+                else:
+                    a = (base & 0x40) | (((base & 0x3F) + c - self.shift) % 40)
+                ch = self.ddram[a]
+                chars.append(chr(ord('0') + ch) if ch < 8 else (chr(ch) if 32 <= ch < 127 else '?'))
+            out.append('|' + ''.join(chars) + '|')
+        state = 'backlight %d/29%s' % (self.backlight, '' if self.display else ', display off')
+        return '\n'.join(out) + '\n' + state + '\n'
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--cols', type=int, default=16)
+    ap.add_argument('--rows', type=int, default=2)
+    ap.add_argument('--log', help='append the received bytes as hex to this file')
+    ap.add_argument('--timeout', type=float, help='exit when nothing was received for this many seconds')
+    args = ap.parse_args()
+
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    print('SerLCD stand-in on %s' % os.ttyname(slave), flush=True)
+
+    lcd = SerLCD(args.cols, args.rows)
+    log = open(args.log, 'a') if args.log else None
+    changed = False
+    last = time.monotonic()
+    try:
+        while True:
+            ready, _, _ = select.select([master], [], [], 0.05)
+            if ready:
+                last = time.monotonic()
+                data = os.read(master, 1024)
+                if log:
+                    log.write(' '.join('%02X' % b for b in data) + '\n')
+                    log.flush()
+                for b in data:
+                    lcd.feed(b)
+                changed = True
+            elif changed:
+                sys.stdout.write(lcd.render())
+                sys.stdout.flush()
+                changed = False
+            elif args.timeout and time.monotonic() - last >= args.timeout:
+                break
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
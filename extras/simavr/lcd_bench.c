@@ -0,0 +1,259 @@
+// lcd_bench.c
+// Runs the benchmark sketches of LiquidCrystal_PCF8574 on a simulated ATmega328P using simavr.
+//
+// A minimal TWI peripheral model ACKs the PCF8574 addresses so the blocking Wire calls
+// of the library take the same number of cycles as with real displays attached.
+// Every address of the range has its own pin state. By default these are the addresses
+// of the PCF8574 (0x20-0x27) and of the PCF8574A (0x38-0x3F), a single address or a range like 0x20-0x23 can be given.
+// The display is always ready: on a read it drives D4-D7 LOW while RW and E are HIGH,
+// so the busy flag is clear with the pin mapping given by -p (default 0,1,2,4,5,6,7 as in the library).
+// The UART output of the sketch is copied to stdout and the simulation stops after the sketch printed "done.".
+// With -t the transactions to the PCF8574 are written to a file in the format of extras/trace/pcf8574_trace.py.
+//
+// The sketch marks its measurements: a value other than 0 written to GPIOR0 starts a section, 0 ends it
+// and GPIOR2:GPIOR1 hold the number of operations. The CPU cycles of the section are counted with avr->cycle.
+// In the next line of the sketch in the form "name: <cycles> cycles, ..." the cycles calculated from micros()
+// (4 us resolution) are replaced by the counted cycles per operation and given in parentheses.
+//
+// usage: lcd_bench [-t trace.txt] [-p rs,rw,en,d4,d5,d6,d7] <firmware.elf> [i2c-address[-last]]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "avr_twi.h"
+#include "avr_uart.h"
+
+#define MAX_CYCLES (600ULL * 16000000ULL) // 10 minutes of simulated time
+
+// marker registers of the ATmega328P in the data space
+#define MARK_SECTION 0x3E // GPIOR0
+#define MARK_OPS_LOW 0x4A // GPIOR1
+#define MARK_OPS_HIGH 0x4B // GPIOR2
+
+static avr_t *avr;
+static avr_irq_t *pcf_irq;
+static FILE *trace;
+static uint8_t pcf_first = 0x20; // ACKed address ranges
+static uint8_t pcf_last = 0x27;
+static uint8_t pcf_firstA = 0x38;
+static uint8_t pcf_lastA = 0x3F;
+static uint8_t pcf_selected;
+static uint8_t pcf_pins[128];
+static uint8_t pcf_rw = 0x02; // pin masks of the adapter
+static uint8_t pcf_en = 0x04;
+static uint8_t pcf_data = 0xF0; // D4-D7
+
+static char uart_line[128];
+static int uart_pos;
+static int done;
+
+static avr_cycle_count_t section_start;
+static int section_open;
+static int section_done; // a section ended, its result goes into the next report line
+static unsigned long long section_cycles; // cycles per operation of the last section
+
+// A PCF8574 ACKs its address and every data byte. A read returns the last written pin state,
+// with D4-D7 driven LOW by the display while it is read (RW and E HIGH).
+static void pcf_twi_hook(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+  avr_twi_msg_irq_t v;
+  v.u.v = value;
+
+  if (v.u.twi.msg & (TWI_COND_STOP | TWI_COND_START)) {
+    if (trace && pcf_selected)
+      fputc('\n', trace);
+    pcf_selected = 0;
+  }
+
+  if (v.u.twi.msg & TWI_COND_START) {
+    uint8_t addr = v.u.twi.addr >> 1;
+    if (((addr >= pcf_first) && (addr <= pcf_last)) || ((addr >= pcf_firstA) && (addr <= pcf_lastA))) {
+      pcf_selected = v.u.twi.addr;
+      if (trace)
+        fprintf(trace, "@%.1f %c %02X", avr->cycle * 1e6 / avr->frequency, (pcf_selected & 1) ? 'R' : 'W', addr);
+      avr_raise_irq(pcf_irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, pcf_selected, 1));
+    }
+  }
+
+  if (pcf_selected) {
+    uint8_t *pins = &pcf_pins[pcf_selected >> 1];
+    if (v.u.twi.msg & TWI_COND_WRITE) {
+      *pins = v.u.twi.data;
+      if (trace)
+        fprintf(trace, " %02X", *pins);
+      avr_raise_irq(pcf_irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, pcf_selected, 1));
+    }
+    if (v.u.twi.msg & TWI_COND_READ) {
+      // the busy flag (D7) is never set: the simulated display is always ready.
+      uint8_t in = *pins;
+      if ((*pins & pcf_rw) && (*pins & pcf_en))
+        in &= ~pcf_data;
+      if (trace)
+        fprintf(trace, " %02X", in);
+      avr_raise_irq(pcf_irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_READ, pcf_selected, in));
+    }
+  }
+} // pcf_twi_hook()
+
+
+// Writes to the marker registers: the value is stored, GPIOR0 starts and ends a section.
+static void marker_hook(struct avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param)
+{
+  avr->data[addr] = v;
+  if (addr != MARK_SECTION)
+    return;
+
+  if (v) {
+    section_start = avr->cycle;
+    section_open = 1;
+  } else if (section_open) {
+    unsigned ops = avr->data[MARK_OPS_LOW] | (avr->data[MARK_OPS_HIGH] << 8);
+    section_cycles = (avr->cycle - section_start) / (ops ? ops : 1);
+    section_open = 0;
+    section_done = 1;
+  }
+} // marker_hook()
+
+
+// Print a line of the sketch, a report line after a section with the counted cycles.
+static void print_line(const char *line)
+{
+  const char *rest = strstr(line, ": ");
+  unsigned long cycles;
+  int n = 0;
+
+  if (section_done && rest && (sscanf(rest + 2, "%lu cycles,%n", &cycles, &n) == 1) && n) {
+    printf("%.*s: %llu cycles,%s (micros(): %lu cycles)\n",
+      (int)(rest - line), line, section_cycles, rest + 2 + n, cycles);
+    section_done = 0;
+  } else {
+    printf("%s\n", line);
+  }
+} // print_line()
+
+
+static void uart_hook(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+  if (value == '\r')
+    return;
+  if (value == '\n') {
+    uart_line[uart_pos] = '\0';
+    print_line(uart_line);
+    if (strncmp(uart_line, "done.", 5) == 0)
+      done = 1;
+    uart_pos = 0;
+  } else if (uart_pos < (int)sizeof(uart_line) - 1) {
+    uart_line[uart_pos++] = (char)value;
+  } else {
+    // a long line is passed through in parts
+    uart_line[uart_pos] = '\0';
+    fputs(uart_line, stdout);
+    uart_pos = 0;
+    uart_line[uart_pos++] = (char)value;
+  }
+} // uart_hook()
+
+
+int main(int argc, char *argv[])
+{
+  static const char *pcf_irq_names[2] = {
+    [TWI_IRQ_INPUT] = "8>pcf8574.out",
+    [TWI_IRQ_OUTPUT] = "32<pcf8574.in"
+  };
+  elf_firmware_t fw = { { 0 } };
+  const char *prog = argv[0];
+  uint32_t flags = 0;
+  int state;
+
+  while ((argc > 2) && (argv[1][0] == '-')) {
+    if (strcmp(argv[1], "-t") == 0) {
+      trace = fopen(argv[2], "w");
+      if (!trace) {
+        fprintf(stderr, "%s: unable to write %s\n", prog, argv[2]);
+        return 2;
+      }
+    } else if (strcmp(argv[1], "-p") == 0) {
+      // pin numbers in the order of the constructor of the library
+      unsigned p[7];
+      int n = sscanf(argv[2], "%u,%u,%u,%u,%u,%u,%u", &p[0], &p[1], &p[2], &p[3], &p[4], &p[5], &p[6]);
+      for (int i = 0; (n == 7) && (i < 7); i++)
+        if (p[i] > 7)
+          n = 0;
+      if (n != 7) {
+        fprintf(stderr, "%s: -p needs 7 pin numbers 0..7: rs,rw,en,d4,d5,d6,d7\n", prog);
+        return 2;
+      }
+      pcf_rw = 1 << p[1];
+      pcf_en = 1 << p[2];
+      pcf_data = (1 << p[3]) | (1 << p[4]) | (1 << p[5]) | (1 << p[6]);
+    } else {
+      break;
+    }
+    argc -= 2;
+    argv += 2;
+  }
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s [-t trace.txt] [-p rs,rw,en,d4,d5,d6,d7] <firmware.elf> [i2c-address[-last]]\n", prog);
+    return 2;
+  }
+  if (argc > 2) {
+    char *end;
+    pcf_first = (uint8_t)strtol(argv[2], &end, 0);
+    pcf_last = (*end == '-') ? (uint8_t)strtol(end + 1, NULL, 0) : pcf_first;
+    pcf_firstA = 0xFF;
+    pcf_lastA = 0;
+  }
+  memset(pcf_pins, 0xFF, sizeof(pcf_pins));
+
+  if (elf_read_firmware(argv[1], &fw) != 0) {
+    fprintf(stderr, "%s: unable to load %s\n", prog, argv[1]);
+    return 2;
+  }
+  if (!fw.mmcu[0])
+    strcpy(fw.mmcu, "atmega328p");
+  if (!fw.frequency)
+    fw.frequency = 16000000;
+
+  avr = avr_make_mcu_by_name(fw.mmcu);
+  if (!avr) {
+    fprintf(stderr, "%s: unknown mcu %s\n", prog, fw.mmcu);
+    return 2;
+  }
+  avr_init(avr);
+  avr_load_firmware(avr, &fw);
+
+  // attach the PCF8574 model to the TWI peripheral
+  pcf_irq = avr_alloc_irq(&avr->irq_pool, 0, 2, pcf_irq_names);
+  avr_irq_register_notify(pcf_irq + TWI_IRQ_OUTPUT, pcf_twi_hook, NULL);
+  avr_connect_irq(pcf_irq + TWI_IRQ_INPUT, avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+  avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), pcf_irq + TWI_IRQ_OUTPUT);
+
+  // capture the serial output instead of the simavr log
+  avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+  flags &= ~AVR_UART_FLAG_STDIO;
+  avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), uart_hook, NULL);
+
+  // count the cycles of the sections the sketch marks
+  avr_register_io_write(avr, MARK_SECTION, marker_hook, NULL);
+  avr_register_io_write(avr, MARK_OPS_LOW, marker_hook, NULL);
+  avr_register_io_write(avr, MARK_OPS_HIGH, marker_hook, NULL);
+
+  do {
+    state = avr_run(avr);
+  } while (!done && state != cpu_Done && state != cpu_Crashed && avr->cycle < MAX_CYCLES);
+
+  fflush(stdout);
+  if (trace)
+    fclose(trace);
+  if (!done) {
+    fprintf(stderr, "%s: benchmark did not finish (state %d, %llu cycles)\n",
+      prog, state, (unsigned long long)avr->cycle);
+    return 1;
+  }
+  return 0;
+} // main()
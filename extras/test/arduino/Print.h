@@ -0,0 +1,48 @@
+// Host stand-in for the Print class of the Arduino core.
+
+#ifndef Print_h
+#define Print_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--)
+      n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+  size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+
+  size_t print(const char *str) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long n)
+  {
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%ld", n);
+    return write(buf);
+  }
+  size_t print(int n) { return print((long)n); }
+  size_t print(unsigned long n)
+  {
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%lu", n);
+    return write(buf);
+  }
+  size_t print(unsigned int n) { return print((unsigned long)n); }
+  size_t println(const char *str) { return print(str) + write("\r\n"); }
+
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+};
+
+#endif
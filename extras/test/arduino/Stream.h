@@ -0,0 +1,28 @@
+// Host stand-in for the Stream class of the Arduino core, without timeouts.
+
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  size_t readBytes(uint8_t *buffer, size_t length)
+  {
+    size_t n = 0;
+    while (n < length) {
+      int c = read();
+      if (c < 0)
+        break;
+      buffer[n++] = (uint8_t)c;
+    }
+    return n;
+  }
+};
+
+#endif
@@ -0,0 +1,28 @@
+// Host stand-in for the Wire library. The transmissions go to the simulated devices of lcd_sim.h.
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32
+
+class TwoWire : public Stream
+{
+public:
+  void begin();
+  void setClock(uint32_t clock);
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity);
+
+  virtual size_t write(uint8_t data);
+  using Print::write;
+  virtual int available();
+  virtual int read();
+  virtual int peek();
+};
+
+extern TwoWire Wire;
+
+#endif
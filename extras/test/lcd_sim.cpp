@@ -0,0 +1,495 @@
+// Simulation of PCF8574 I2C adapters with HD44780 displays for the host tests.
+
+#include "lcd_sim.h"
+#include <Wire.h>
+
+#define LCD_SIM_MAX 16
+
+LcdSimBus simBus;
+unsigned long sim_us = 0;
+TwoWire Wire;
+
+static LcdSim *devices[LCD_SIM_MAX];
+
+static uint8_t txAddress;
+static uint8_t txBuffer[BUFFER_LENGTH];
+static uint8_t txLength;
+static uint8_t rxBuffer[BUFFER_LENGTH];
+static uint8_t rxLength;
+static uint8_t rxIndex;
+
+
+// == simulated time
+
+unsigned long millis() { return sim_us / 1000; }
+unsigned long micros() { return sim_us; }
+void delay(unsigned long ms) { sim_us += ms * 1000; }
+void delayMicroseconds(unsigned int us) { sim_us += us; }
+
+
+// == Wire stand-in
+
+void TwoWire::begin() {}
+void TwoWire::setClock(uint32_t) {}
+
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  txAddress = address;
+  txLength = 0;
+} // beginTransmission()
+
+
+size_t TwoWire::write(uint8_t data)
+{
+  if (txLength >= BUFFER_LENGTH) {
+    simBus.overflows++;
+    return 0;
+  }
+  txBuffer[txLength++] = data;
+  return 1;
+} // write()
+
+
+// The time of the address or data bytes on the bus.
+static void busTime(unsigned long bytes)
+{
+  sim_us += bytes * LCD_SIM_BYTE_TIME;
+  simBus.busyTime += bytes * LCD_SIM_BYTE_TIME;
+}
+
+
+/// Returns 2 like the Wire library when the address is not acknowledged,
+/// 3 when a data byte is not acknowledged and 5 after a timeout.
+uint8_t TwoWire::endTransmission(bool)
+{
+  LcdSim *d = LcdSim::find(txAddress);
+  uint8_t fault = LCD_FAULT_NONE;
+  uint8_t length = txLength;
+
+  simBus.transmissions++;
+  txLength = 0;
+  if (d) {
+    d->transmissions++;
+    fault = d->fault();
+    // faults of reads and a data NACK after the last byte do not change a write
+    if ((fault == LCD_FAULT_FLIP) || (fault == LCD_FAULT_SHORT_READ)
+      || ((fault == LCD_FAULT_NACK_DATA) && (d->nackByte >= length)))
+      fault = LCD_FAULT_NONE;
+    if (fault != LCD_FAULT_NONE)
+      d->faults++;
+  }
+
+  if (fault == LCD_FAULT_TIMEOUT) {
+    sim_us += d->wireTimeout;
+    simBus.busyTime += d->wireTimeout;
+    return 5;
+  }
+  busTime(1);
+  if (!d || (fault == LCD_FAULT_NACK_ADDRESS))
+    return 2;
+
+  if (fault == LCD_FAULT_NACK_DATA) {
+    // the bytes before the byte that is not acknowledged are taken by the PCF8574
+    length = d->nackByte;
+    busTime(1);
+  }
+
+  for (uint8_t i = 0; i < length; i++) {
+    busTime(1);
+    simBus.bytes++;
+    d->write(txBuffer[i]);
+  }
+  return (fault == LCD_FAULT_NACK_DATA) ? 3 : 0;
+} // endTransmission()
+
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity)
+{
+  LcdSim *d = LcdSim::find(address);
+  uint8_t fault = LCD_FAULT_NONE;
+
+  simBus.transmissions++;
+  rxLength = rxIndex = 0;
+  if (d) {
+    d->transmissions++;
+    fault = d->fault();
+    // the master does not acknowledge the data bytes of a read
+    if (fault == LCD_FAULT_NACK_DATA)
+      fault = LCD_FAULT_NONE;
+    if (fault != LCD_FAULT_NONE)
+      d->faults++;
+  }
+
+  if (fault == LCD_FAULT_TIMEOUT) {
+    sim_us += d->wireTimeout;
+    simBus.busyTime += d->wireTimeout;
+    return 0;
+  }
+  busTime(1);
+  if (!d || (fault == LCD_FAULT_NACK_ADDRESS) || (fault == LCD_FAULT_SHORT_READ))
+    return 0;
+
+  if (quantity > BUFFER_LENGTH)
+    quantity = BUFFER_LENGTH;
+  while (rxLength < quantity) {
+    busTime(1);
+    simBus.bytes++;
+    rxBuffer[rxLength] = d->read();
+    if (fault == LCD_FAULT_FLIP)
+      rxBuffer[rxLength] ^= d->flipMask;
+    rxLength++;
+  }
+  return rxLength;
+} // requestFrom()
+
+
+int TwoWire::available() { return rxLength - rxIndex; }
+int TwoWire::read() { return (rxIndex < rxLength) ? rxBuffer[rxIndex++] : -1; }
+int TwoWire::peek() { return (rxIndex < rxLength) ? rxBuffer[rxIndex] : -1; }
+
+
+// == PCF8574 with HD44780
+
+static uint8_t pinMask(uint8_t pin)
+{
+  return (pin < 8) ? (0x01 << pin) : 0;
+}
+
+
+LcdSim::LcdSim(uint8_t address, uint8_t rs, uint8_t rw, uint8_t enable,
+    uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7, uint8_t backlight)
+{
+  _address = address;
+  _rs = pinMask(rs);
+  _rw = pinMask(rw);
+  _enable = pinMask(enable);
+  _backlight = pinMask(backlight);
+  _data[0] = pinMask(d4);
+  _data[1] = pinMask(d5);
+  _data[2] = pinMask(d6);
+  _data[3] = pinMask(d7);
+
+  nack = false;
+  stuckBusy = false;
+  shortRead = false;
+  nackByte = 1;
+  flipMask = 0xFF;
+  wireTimeout = LCD_SIM_WIRE_TIMEOUT;
+  buttons = 0;
+  clearFaults();
+  transmissions = 0;
+  instructions = 0;
+  characters = 0;
+  violations = 0;
+  busyWrites = 0;
+  shiftTime = 0;
+  faults = 0;
+  memset(ddramWrites, 0, sizeof(ddramWrites));
+
+  for (uint8_t n = 0; n < LCD_SIM_MAX; n++) {
+    if (!devices[n]) {
+      devices[n] = this;
+      break;
+    }
+  }
+  _port = 0xFF; // the PCF8574 starts with all pins HIGH
+  power();
+} // LcdSim
+
+
+LcdSim::~LcdSim()
+{
+  for (uint8_t n = 0; n < LCD_SIM_MAX; n++) {
+    if (devices[n] == this)
+      devices[n] = NULL;
+  }
+} // ~LcdSim
+
+
+LcdSim *LcdSim::find(uint8_t address)
+{
+  for (uint8_t n = 0; n < LCD_SIM_MAX; n++) {
+    if (devices[n] && (devices[n]->_address == address))
+      return devices[n];
+  }
+  return NULL;
+} // find()
+
+
+bool LcdSim::failTransmissions(uint8_t type, unsigned long next, unsigned long count)
+{
+  for (uint8_t n = 0; n < LCD_SIM_FAULTS; n++) {
+    LcdSimFault &f = _faults[n];
+    if (f.type == LCD_FAULT_NONE) {
+      f.type = type;
+      f.first = transmissions + next;
+      f.count = count;
+      return true;
+    }
+  }
+  return false;
+} // failTransmissions()
+
+
+bool LcdSim::failFor(uint8_t type, unsigned long duration, unsigned long after)
+{
+  for (uint8_t n = 0; n < LCD_SIM_FAULTS; n++) {
+    LcdSimFault &f = _faults[n];
+    if (f.type == LCD_FAULT_NONE) {
+      f.type = type;
+      f.count = 0;
+      f.start = sim_us + after;
+      f.duration = duration;
+      return true;
+    }
+  }
+  return false;
+} // failFor()
+
+
+void LcdSim::clearFaults()
+{
+  memset(_faults, 0, sizeof(_faults));
+} // clearFaults()
+
+
+/// The permanent faults first, then the scheduled ones. Schedules that are over are removed.
+uint8_t LcdSim::fault()
+{
+  uint8_t type = LCD_FAULT_NONE;
+
+  if (nack)
+    return LCD_FAULT_NACK_ADDRESS;
+  if (shortRead)
+    type = LCD_FAULT_SHORT_READ;
+
+  for (uint8_t n = 0; n < LCD_SIM_FAULTS; n++) {
+    LcdSimFault &f = _faults[n];
+    if (f.type == LCD_FAULT_NONE)
+      continue;
+    if (f.count > 0) {
+      if (transmissions >= f.first + f.count)
+        f.type = LCD_FAULT_NONE;
+      else if ((transmissions >= f.first) && (type == LCD_FAULT_NONE))
+        type = f.type;
+    } else if ((long)(sim_us - f.start) < 0) {
+      // the time has not started yet
+    } else if (sim_us - f.start >= f.duration) {
+      f.type = LCD_FAULT_NONE;
+    } else if (type == LCD_FAULT_NONE) {
+      type = f.type;
+    }
+  }
+  return type;
+} // fault()
+
+
+void LcdSim::power()
+{
+  memset(_ddram, ' ', sizeof(_ddram));
+  memset(_cgram, 0, sizeof(_cgram));
+  _ac = 0;
+  _cg = false;
+  _shift = 0;
+  _entryMode = 0x02;
+  _displayControl = 0x00;
+  _fourBit = false;
+  _twoLines = false;
+  _high = true;
+  _nibble = 0;
+  _out = 0;
+  _busyUntil = sim_us + 15000;
+} // power()
+
+
+std::string LcdSim::row(uint8_t row, uint8_t cols)
+{
+  static const uint8_t offsets[] = { 0x00, 0x40, 0x14, 0x54 };
+  std::string s;
+
+  for (uint8_t col = 0; col < cols; col++) {
+    uint8_t addr;
+    if (_twoLines) {
+      uint8_t base = offsets[row & 0x03];
+      addr = (base & 0x40) | (((base & 0x3F) + col + _shift) % 40);
+    } else {
+      addr = (col + _shift) % 80;
+    }
+    uint8_t c = _ddram[addr];
+    s += (c < 8) ? (char)('0' + c) : (char)c;
+  }
+  return s;
+} // row()
+
+
+/// A byte written to the PCF8574 sets all pins.
+void LcdSim::write(uint8_t value)
+{
+  bool rising = !(_port & _enable) && (value & _enable);
+  bool falling = (_port & _enable) && !(value & _enable);
+
+  if (rising) {
+    // RS and RW must be stable before E rises (address setup time)
+    if ((value ^ _port) & (_rs | _rw))
+      violations++;
+
+    if (value & _rw) {
+      // the display drives the data pins while E is high
+      uint8_t status = (_busy() ? 0x80 : 0x00) | _ac;
+      if (value & _rs)
+        status = 0; // data reads are not used by the library
+      _out = (!_fourBit || _high) ? (status >> 4) : (status & 0x0F);
+    }
+
+  } else if (falling) {
+    if (_port & _rw) {
+      if (_fourBit)
+        _high = !_high;
+    } else {
+      // data is taken from the pins while E was high
+      _receive(_dataPins(_port), _port & _rs);
+    }
+  }
+  _port = value;
+} // write()
+
+
+/// Reading the PCF8574: pins that are written HIGH can be pulled LOW by the display or a button.
+uint8_t LcdSim::read()
+{
+  uint8_t in = _port & ~buttons;
+
+  if ((_port & _rw) && (_port & _enable)) {
+    for (uint8_t i = 0; i < 4; i++) {
+      if (!(_out & (0x01 << i)))
+        in &= ~_data[i];
+    }
+  }
+  return in;
+} // read()
+
+
+uint8_t LcdSim::_dataPins(uint8_t value)
+{
+  uint8_t nibble = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    if (value & _data[i])
+      nibble |= (0x01 << i);
+  }
+  return nibble;
+} // _dataPins()
+
+
+void LcdSim::_receive(uint8_t nibble, bool rs)
+{
+  if (!_fourBit) {
+    // 8-bit interface: D0-D3 are not connected and read as 0
+    _execute(nibble << 4, rs);
+  } else if (_high) {
+    _nibble = nibble;
+    _high = false;
+  } else {
+    _high = true;
+    _execute((_nibble << 4) | nibble, rs);
+  }
+} // _receive()
+
+
+void LcdSim::_execute(uint8_t value, bool rs)
+{
+  unsigned long duration = 37;
+
+  if (_busy())
+    busyWrites++;
+
+  if (rs) {
+    characters++;
+    if (_cg) {
+      _cgram[_ac & 0x3F] = value;
+      _ac = (_ac + ((_entryMode & 0x02) ? 1 : -1)) & 0x3F;
+    } else {
+      _ddram[_ac & 0x7F] = value;
+      ddramWrites[_ac & 0x7F]++;
+      _step(_entryMode & 0x02);
+      if (_entryMode & 0x01)
+        _shiftDisplay(_entryMode & 0x02);
+    }
+    duration = 41;
+
+  } else {
+    instructions++;
+    if (value & 0x80) {
+      _ac = value & 0x7F;
+      _cg = false;
+    } else if (value & 0x40) {
+      _ac = value & 0x3F;
+      _cg = true;
+    } else if (value & 0x20) {
+      if (_fourBit == !!(value & 0x10))
+        _high = true;
+      _fourBit = !(value & 0x10);
+      _twoLines = (value & 0x08);
+    } else if (value & 0x10) {
+      if (value & 0x08)
+        _shiftDisplay(!(value & 0x04));
+      else
+        _step(value & 0x04);
+    } else if (value & 0x08) {
+      _displayControl = value & 0x07;
+    } else if (value & 0x04) {
+      _entryMode = value & 0x03;
+    } else if (value & 0x03) {
+      if (value & 0x01) {
+        memset(_ddram, ' ', sizeof(_ddram));
+        _entryMode |= 0x02;
+      }
+      _ac = 0;
+      _cg = false;
+      if (_shift != 0)
+        shiftTime = sim_us;
+      _shift = 0;
+      duration = 1520;
+    }
+  }
+  _busyUntil = sim_us + duration;
+} // _execute()
+
+
+void LcdSim::_step(bool increment)
+{
+  if (_cg) {
+    _ac = (_ac + (increment ? 1 : -1)) & 0x3F;
+  } else if (_twoLines) {
+    if (increment) {
+      _ac++;
+      if (_ac == 0x28) _ac = 0x40;
+      else if (_ac >= 0x68) _ac = 0x00;
+    } else {
+      if (_ac == 0x00) _ac = 0x67;
+      else if (_ac == 0x40) _ac = 0x27;
+      else _ac--;
+    }
+  } else {
+    if (increment)
+      _ac = (_ac >= 0x4F) ? 0 : _ac + 1;
+    else
+      _ac = (_ac == 0) ? 0x4F : _ac - 1;
+  }
+} // _step()
+
+
+void LcdSim::_shiftDisplay(bool left)
+{
+  uint8_t lineLen = _twoLines ? 40 : 80;
+  _shift = left ? (_shift + 1) % lineLen : (_shift + lineLen - 1) % lineLen;
+  shiftTime = sim_us;
+} // _shiftDisplay()
+
+
+bool LcdSim::_busy()
+{
+  return stuckBusy || (sim_us < _busyUntil);
+} // _busy()
+
+// The End.
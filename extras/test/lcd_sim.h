@@ -0,0 +1,143 @@
+// Simulation of PCF8574 I2C adapters with HD44780 displays for the host tests.
+//
+// The Wire stand-in delivers every transmission to the LcdSim registered at the address.
+// An LcdSim follows the pins of the PCF8574 like the HD44780 does: instructions and data
+// are taken at the falling edge of E, the busy flag and the address counter are read back
+// with the pin mapping of the adapter. The bus runs at 100 kHz in the simulated time,
+// the display has the execution times of the datasheet.
+//
+// Faults for the error paths of the library: an adapter that does not acknowledge its address or a data byte,
+// transmissions that hang until the timeout of the Wire library, a stuck bus, flipped bits in the bytes read,
+// reads that return no data and a busy flag that never clears. Faults are permanent by the flags
+// or scheduled for some transmissions to the address (failTransmissions()) or for a time (failFor()).
+
+#ifndef lcd_sim_h
+#define lcd_sim_h
+
+#include <Arduino.h>
+#include <string>
+
+#define LCD_SIM_BYTE_TIME 90 ///< microseconds for one byte on the bus at 100 kHz
+#define LCD_SIM_WIRE_TIMEOUT 25000 ///< default timeout of the Wire library in microseconds
+#define LCD_SIM_FAULTS 4 ///< scheduled faults per display
+
+// faults of a transmission
+#define LCD_FAULT_NONE 0
+#define LCD_FAULT_NACK_ADDRESS 1 ///< the address is not acknowledged, endTransmission() returns 2
+#define LCD_FAULT_NACK_DATA 2 ///< a data byte is not acknowledged, the bytes before it arrive, endTransmission() returns 3
+#define LCD_FAULT_TIMEOUT 3 ///< the transmission hangs until the Wire timeout, endTransmission() returns 5, no data is read
+#define LCD_FAULT_FLIP 4 ///< the bits of flipMask are inverted in the bytes read
+#define LCD_FAULT_SHORT_READ 5 ///< requests return no data
+
+/// Counters of the simulated bus, reads count as transmissions.
+struct LcdSimBus {
+  unsigned long transmissions; ///< write transmissions and read requests
+  unsigned long bytes; ///< bytes written and read, without the address bytes
+  unsigned long overflows; ///< bytes that did not fit into the Wire buffer
+  unsigned long busyTime; ///< microseconds the bus was in use
+};
+
+/// A fault for a number of transmissions or for a time.
+struct LcdSimFault {
+  uint8_t type; ///< LCD_FAULT_*, LCD_FAULT_NONE for an unused entry
+  unsigned long first; ///< number of the first transmission to the address with the fault
+  unsigned long count; ///< number of transmissions with the fault, 0 for a time
+  unsigned long start; ///< start of the time in microseconds
+  unsigned long duration; ///< length of the time in microseconds
+};
+
+extern LcdSimBus simBus;
+extern unsigned long sim_us; ///< simulated time in microseconds
+
+class LcdSim
+{
+public:
+  // a display at an I2C address with the pin mapping of the adapter, 255 for a pin that is not connected.
+  LcdSim(uint8_t address = 0x27, uint8_t rs = 0, uint8_t rw = 1, uint8_t enable = 2,
+    uint8_t d4 = 4, uint8_t d5 = 5, uint8_t d6 = 6, uint8_t d7 = 7, uint8_t backlight = 3);
+  ~LcdSim();
+
+  static LcdSim *find(uint8_t address);
+
+  // the state after power on: 8-bit interface, empty display RAM, busy for 15 msec.
+  void power();
+
+  // the visible characters of a row, custom characters 0..7 as '0'..'7'.
+  std::string row(uint8_t row, uint8_t cols);
+
+  uint8_t ddram(uint8_t addr) { return _ddram[addr & 0x7F]; }
+  uint8_t cgram(uint8_t addr) { return _cgram[addr & 0x3F]; }
+  uint8_t ac() { return _ac; }
+  uint8_t shift() { return _shift; } ///< positions the display is shifted to the left
+  uint8_t entryMode() { return _entryMode; }
+  uint8_t displayControl() { return _displayControl; }
+  bool fourBit() { return _fourBit; }
+  bool twoLines() { return _twoLines; }
+  bool backlight() { return _backlight && (_port & _backlight); }
+  uint8_t port() { return _port; }
+
+  // faults
+  bool nack; ///< the adapter does not acknowledge its address
+  bool stuckBusy; ///< the busy flag never clears
+  bool shortRead; ///< requests return no data
+  uint8_t nackByte; ///< LCD_FAULT_NACK_DATA: bytes that arrive before the byte that is not acknowledged
+  uint8_t flipMask; ///< LCD_FAULT_FLIP: bits inverted in the bytes read
+  unsigned long wireTimeout; ///< LCD_FAULT_TIMEOUT: microseconds until the Wire library gives up
+  uint8_t buttons; ///< pins pulled to GND
+
+  // a fault for count transmissions, starting with the next one (next = 1) or a later one
+  bool failTransmissions(uint8_t type, unsigned long next = 1, unsigned long count = 1);
+
+  // a fault for a time in microseconds, starting now or after a delay. A stuck bus is LCD_FAULT_TIMEOUT for a time.
+  bool failFor(uint8_t type, unsigned long duration, unsigned long after = 0);
+
+  void clearFaults();
+
+  // the fault of the current transmission, used by the Wire stand-in
+  uint8_t fault();
+
+  // counters
+  unsigned long transmissions; ///< transmissions and requests to this address
+  unsigned long instructions;
+  unsigned long characters; ///< data written to the display or character generator RAM
+  unsigned long violations; ///< RS or RW changed together with the rising E
+  unsigned long busyWrites; ///< instructions or data sent while the display was busy
+  unsigned long shiftTime; ///< time of the last change of the display shift
+  unsigned long faults; ///< transmissions that were changed by a fault
+  unsigned long ddramWrites[128]; ///< characters written to every display RAM address
+
+  // used by the Wire stand-in
+  void write(uint8_t value);
+  uint8_t read();
+
+private:
+  uint8_t _address;
+  LcdSimFault _faults[LCD_SIM_FAULTS];
+  uint8_t _rs, _rw, _enable, _backlight;
+  uint8_t _data[4];
+
+  uint8_t _port; ///< output latch of the PCF8574
+  uint8_t _out; ///< nibble the display drives during a read
+
+  uint8_t _ddram[128];
+  uint8_t _cgram[64];
+  uint8_t _ac;
+  bool _cg; ///< the address counter points to the character generator RAM
+  uint8_t _shift;
+  uint8_t _entryMode;
+  uint8_t _displayControl;
+  bool _fourBit;
+  bool _twoLines;
+  bool _high; ///< the next nibble is the high nibble
+  uint8_t _nibble; ///< the received high nibble
+  unsigned long _busyUntil;
+
+  uint8_t _dataPins(uint8_t value);
+  void _receive(uint8_t nibble, bool rs);
+  void _execute(uint8_t value, bool rs);
+  void _step(bool increment);
+  void _shiftDisplay(bool left);
+  bool _busy();
+};
+
+#endif
@@ -0,0 +1,54 @@
+// Checks for the host tests. Every test is a program that returns 0 when all checks passed.
+
+#ifndef test_h
+#define test_h
+
+#include <stdio.h>
+#include <string>
+
+static int test_checks = 0;
+static int test_failures = 0;
+
+static inline bool test_check(bool ok, const char *expr, const char *file, int line)
+{
+  test_checks++;
+  if (!ok) {
+    test_failures++;
+    printf("%s:%d: check failed: %s\n", file, line, expr);
+  }
+  return ok;
+}
+
+static inline bool test_equal(long actual, long expected, const char *expr, const char *file, int line)
+{
+  test_checks++;
+  if (actual != expected) {
+    test_failures++;
+    printf("%s:%d: check failed: %s is %ld, expected %ld\n", file, line, expr, actual, expected);
+    return false;
+  }
+  return true;
+}
+
+static inline bool test_equal(const std::string &actual, const std::string &expected, const char *expr, const char *file, int line)
+{
+  test_checks++;
+  if (actual != expected) {
+    test_failures++;
+    printf("%s:%d: check failed: %s is \"%s\", expected \"%s\"\n", file, line, expr, actual.c_str(), expected.c_str());
+    return false;
+  }
+  return true;
+}
+
+#define CHECK(cond) test_check((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQUAL(actual, expected) test_equal((actual), (expected), #actual, __FILE__, __LINE__)
+
+// print the summary, the result is the exit code of the test
+static inline int test_result(const char *name)
+{
+  printf("%s: %d checks, %d failed\n", name, test_checks, test_failures);
+  return (test_failures == 0) ? 0 : 1;
+}
+
+#endif
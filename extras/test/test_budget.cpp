@@ -0,0 +1,127 @@
+// Test of the bus budget: the transmissions and bytes of the common operations that are listed in README.md.
+//
+// The numbers are for the default pin assignment, a Wire buffer of 32 bytes and the RW line connected.
+// Reads of the busy flag count as transmissions, their bytes are counted like written bytes.
+// The bus runs at 100 kHz and the display has the execution times of the datasheet,
+// so the number of busy flag reads of begin() and clear() depends on these times.
+// The expected numbers are read from the table in README.md, so a change of the library that changes a number
+// fails until the table is updated with it.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+
+#define README "../../README.md"
+
+// the first column of the rows of the table in README.md
+static const char *operations[] = {
+  "`begin(20, 4)`",
+  "`write('a')` after an instruction",
+  "`print()` of 20 characters",
+  "`setCursor()`",
+  "`cursor()` (display control flag)",
+  "`createChar()`",
+  "full repaint of a 20x4 display",
+  "`clear()`",
+  "`setBacklight()`",
+};
+
+static LcdSimBus before;
+
+
+// the numbers of a row of the table, false when the row is missing.
+static bool readme(const char *operation, unsigned long *transmissions, unsigned long *bytes)
+{
+  char line[256];
+  char name[64];
+  bool found = false;
+  FILE *f = fopen(README, "r");
+
+  if (!f)
+    return false;
+  while (!found && fgets(line, sizeof(line), f)) {
+    if ((sscanf(line, "| %63[^|] | %lu | %lu |", name, transmissions, bytes) == 3)) {
+      size_t len = strlen(name);
+      while ((len > 0) && (name[len - 1] == ' '))
+        name[--len] = '\0';
+      found = (strcmp(name, operation) == 0);
+    }
+  }
+  fclose(f);
+  return found;
+}
+
+static void start()
+{
+  before = simBus;
+}
+
+static void measure(uint8_t n)
+{
+  unsigned long transmissions = simBus.transmissions - before.transmissions;
+  unsigned long bytes = simBus.bytes - before.bytes;
+  unsigned long expectedTransmissions, expectedBytes;
+
+  printf("| %-34s | %13lu | %5lu |\n", operations[n], transmissions, bytes);
+  if (!CHECK(readme(operations[n], &expectedTransmissions, &expectedBytes))) {
+    printf("row \"%s\" not found in %s\n", operations[n], README);
+    return;
+  }
+  CHECK_EQUAL(transmissions, expectedTransmissions);
+  CHECK_EQUAL(bytes, expectedBytes);
+  CHECK_EQUAL(simBus.overflows, 0);
+}
+
+
+int main()
+{
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  const char *line = "01234567890123456789";
+  byte bar[8] = { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F };
+  uint8_t n = 0;
+
+  start();
+  lcd.begin(20, 4);
+  measure(n++);
+
+  start();
+  lcd.write('a');
+  measure(n++);
+
+  start();
+  lcd.print(line);
+  measure(n++);
+
+  start();
+  lcd.setCursor(3, 1);
+  measure(n++);
+
+  start();
+  lcd.cursor();
+  measure(n++);
+
+  start();
+  lcd.createChar(0, bar);
+  measure(n++);
+
+  start();
+  for (uint8_t row = 0; row < 4; row++) {
+    lcd.setCursor(0, row);
+    lcd.print(line);
+  }
+  measure(n++);
+
+  start();
+  lcd.clear();
+  measure(n++);
+
+  start();
+  lcd.setBacklight(255);
+  measure(n++);
+
+  CHECK_EQUAL(sim.violations, 0);
+  CHECK_EQUAL(sim.busyWrites, 0);
+  CHECK_EQUAL(sim.row(0, 20), "                    ");
+  return test_result("test_budget");
+}
@@ -0,0 +1,209 @@
+// Test of the line editor: random edits compared with a model of the text and the display RAM.
+//
+// After every edit the text of the editor, the display RAM of the field, the rest of the display RAM,
+// the address counter and the display shift are checked. The characters outside of the field must never change
+// and the cursor must always be at the edit position inside the visible part of the field.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+#include <LiquidCrystal_PCF8574_Editor.h>
+
+#define SEED 20261018UL
+#define EDITS 3000
+#define SIZE 48 ///< size of the text buffer
+
+static unsigned long rnd_state;
+
+// a small LCG so the sequence does not depend on the C library
+static unsigned int rnd(unsigned int n)
+{
+  rnd_state = rnd_state * 1103515245UL + 12345UL;
+  return ((rnd_state >> 16) & 0x7FFF) % n;
+}
+
+
+// the display RAM address of a column of a row without display shift
+static uint8_t address(uint8_t rows, uint8_t col, uint8_t row)
+{
+  static const uint8_t base[4] = { 0x00, 0x40, 0x14, 0x54 };
+  if (rows <= 1)
+    return col % 80;
+  return (base[row] & 0x40) | (((base[row] & 0x3F) + col) % 40);
+}
+
+
+/// A field of an editor on a display with some text around it.
+struct Field {
+  const char *name;
+  uint8_t cols, rows;
+  uint8_t col, row, width;
+  bool panning; ///< the field ends at the right edge of a display with up to 2 lines
+};
+
+
+// the longest text: up to the end of the display RAM line when panning, otherwise the field width
+static uint8_t maxLength(const Field &f)
+{
+  uint8_t lineLen = (f.rows > 1) ? 40 : 80;
+  uint8_t max = f.panning ? lineLen - f.col - 1 : f.width - 1;
+  return (max < SIZE - 1) ? max : SIZE - 1;
+}
+
+
+static bool compare(LcdSim &sim, LiquidCrystal_PCF8574_Editor &editor, const Field &f,
+  const uint8_t *before, const std::string &text, uint8_t pos, unsigned long n)
+{
+  uint8_t max = maxLength(f);
+  uint8_t region = (max > f.width) ? max : f.width;
+  uint8_t expected[128];
+  bool ok = true;
+
+  memcpy(expected, before, sizeof(expected));
+  for (uint8_t i = 0; i < region; i++)
+    expected[address(f.rows, f.col + i, f.row)] = (i < text.size()) ? text[i] : ' ';
+
+  ok &= CHECK_EQUAL(editor.text(), text);
+  ok &= CHECK_EQUAL(editor.length(), text.size());
+  ok &= CHECK_EQUAL(editor.position(), pos);
+  for (uint8_t a = 0; a < 128; a++) {
+    if ((f.rows > 1) ? ((a & 0x3F) >= 40) : (a >= 80))
+      continue;
+    ok &= CHECK_EQUAL(sim.ddram(a), expected[a]);
+  }
+
+  // the cursor is at the edit position and visible in the field
+  ok &= CHECK_EQUAL(sim.ac(), address(f.rows, f.col + pos, f.row));
+  if (f.panning) {
+    ok &= CHECK(sim.shift() <= pos);
+    ok &= CHECK(pos < sim.shift() + f.width);
+  } else {
+    ok &= CHECK_EQUAL(sim.shift(), 0);
+  }
+  ok &= CHECK_EQUAL(sim.violations, 0);
+  ok &= CHECK_EQUAL(sim.busyWrites, 0);
+  if (!ok)
+    printf("%s: after edit %lu of the sequence with seed %lu\n", f.name, n, SEED);
+  return ok;
+}
+
+
+static void edit(const Field &f, const char *around)
+{
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  char buffer[SIZE] = "";
+  uint8_t before[128];
+  uint8_t max = maxLength(f);
+  std::string text;
+  uint8_t pos = 0;
+
+  rnd_state = SEED;
+  lcd.begin(f.cols, f.rows);
+  for (uint8_t row = 0; row < f.rows; row++) {
+    lcd.setCursor(0, row);
+    lcd.print(around);
+  }
+  for (uint8_t a = 0; a < 128; a++)
+    before[a] = sim.ddram(a);
+
+  LiquidCrystal_PCF8574_Editor editor(lcd, buffer, sizeof(buffer), f.col, f.row, f.width);
+  editor.begin();
+  compare(sim, editor, f, before, text, pos, 0);
+
+  for (unsigned long n = 1; n <= EDITS; n++) {
+    switch (rnd(10)) {
+      case 0:
+      case 1:
+      case 2:
+      case 3: {
+        char c = 'a' + rnd(26);
+        CHECK_EQUAL(editor.insert(c), text.size() < max);
+        if (text.size() < max)
+          text.insert(pos++, 1, c);
+        break;
+      }
+      case 4:
+        CHECK_EQUAL(editor.backspace(), pos > 0);
+        if (pos > 0)
+          text.erase(--pos, 1);
+        break;
+      case 5:
+        CHECK_EQUAL(editor.remove(), pos < text.size());
+        if (pos < text.size())
+          text.erase(pos, 1);
+        break;
+      case 6:
+        CHECK_EQUAL(editor.left(), pos > 0);
+        if (pos > 0)
+          pos--;
+        break;
+      case 7:
+        CHECK_EQUAL(editor.right(), pos < text.size());
+        if (pos < text.size())
+          pos++;
+        break;
+      case 8:
+        // the application has moved the address counter
+        if (rnd(2))
+          lcd.setCursor(0, (f.row + 1) % f.rows);
+        pos = rnd(text.size() + 3);
+        editor.moveTo(pos);
+        if (pos > text.size())
+          pos = text.size();
+        break;
+      default:
+        // leave and enter the field again, the cursor goes to the end
+        if (rnd(10) == 0) {
+          editor.end();
+          CHECK_EQUAL(sim.shift(), 0);
+          CHECK_EQUAL(sim.displayControl() & 0x02, 0);
+          editor.begin();
+          pos = text.size();
+        }
+        break;
+    }
+    if (!compare(sim, editor, f, before, text, pos, n))
+      return;
+  }
+
+  editor.end();
+  CHECK_EQUAL(sim.shift(), 0);
+  CHECK_EQUAL(lcd.lastError(), 0);
+} // edit()
+
+
+int main()
+{
+  // a field at the right edge of a 16x2 display pans through the display RAM line
+  Field pan16x2 = { "16x2 panning", 16, 2, 5, 0, 11, true };
+  edit(pan16x2, "Name:");
+
+  // a field with other text after it is limited to its width
+  Field fixed16x2 = { "16x2 fixed", 16, 2, 5, 0, 5, false };
+  edit(fixed16x2, "Name:     |label");
+
+  // on 4 lines a display RAM line holds 2 rows, no panning
+  Field fixed20x4 = { "20x4", 20, 4, 6, 2, 10, false };
+  edit(fixed20x4, "Field:          |end");
+
+  Field pan40x1 = { "40x1 panning", 40, 1, 30, 0, 10, true };
+  edit(pan40x1, "Value:");
+
+  // typing past a field that has text after it: the text stops at the field width and the display does not move
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  char name[16] = "";
+  lcd.begin(16, 2);
+  lcd.print("Name:     |label");
+  LiquidCrystal_PCF8574_Editor editor(lcd, name, sizeof(name), 5, 0, 5);
+  editor.begin();
+  for (const char *p = "abcdefgh"; *p; p++)
+    editor.insert(*p);
+  CHECK_EQUAL(editor.text(), "abcd");
+  CHECK_EQUAL(sim.shift(), 0);
+  editor.end();
+  CHECK_EQUAL(sim.row(0, 16), "Name:abcd |label");
+
+  return test_result("test_editor");
+}
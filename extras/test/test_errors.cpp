@@ -0,0 +1,228 @@
+// Test of the error paths with the faults of the simulation: adapters that do not acknowledge the address or data,
+// timeouts of the Wire library, a stuck bus, flipped bits in the reads of the busy flag, a busy flag that does not clear
+// and short reads. For every fault the test prints how long the driver blocked and how long it took
+// to show the correct screen again, lastError() tells the application that the display must be initialized again.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+#include <new>
+
+#define BUSY_TIMEOUT 10000 // LCD_BUSY_TIMEOUT of the library
+
+static const char *screen = "0123456789abcdef";
+
+
+// show the screen again like an application does after an error. Returns the time it took.
+static unsigned long recover(LiquidCrystal_PCF8574 &lcd)
+{
+  unsigned long t = micros();
+  lcd.begin(16, 2);
+  lcd.print(screen);
+  return micros() - t;
+}
+
+int main()
+{
+  LcdSim sim(0x27);
+
+  // an instance in uninitialized memory starts without an error
+  static uint8_t memory[sizeof(LiquidCrystal_PCF8574)];
+  memset(memory, 0xAA, sizeof(memory));
+  LiquidCrystal_PCF8574 &lcd = *new (memory) LiquidCrystal_PCF8574(0x27);
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  lcd.begin(16, 2);
+  CHECK_EQUAL(lcd.lastError(), 0);
+  lcd.print("hello");
+
+  // so a display that stayed powered keeps its content
+  memset(memory, 0xAA, sizeof(memory));
+  new (memory) LiquidCrystal_PCF8574(0x27);
+  CHECK(lcd.beginWarm(16, 2));
+  CHECK_EQUAL(sim.row(0, 16), "hello           ");
+
+  // the adapter does not acknowledge: the first error is kept until lastError()
+  sim.nack = true;
+  lcd.setCursor(0, 1);
+  lcd.print("lost");
+  CHECK_EQUAL(lcd.waitBusy(), -1);
+  CHECK_EQUAL(lcd.lastError(), 2);
+  CHECK_EQUAL(lcd.lastError(), 0);
+  CHECK_EQUAL(sim.row(1, 16), "                ");
+
+  // the position is not known anymore, writeAt() sets the cursor again
+  sim.nack = false;
+  unsigned long t = sim.instructions;
+  lcd.writeAt(0, 1, (const uint8_t *)"back", 4);
+  CHECK_EQUAL(sim.instructions - t, 1);
+  CHECK_EQUAL(sim.row(1, 16), "back            ");
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  // a busy flag that does not clear: waitBusy() gives up after the timeout
+  sim.stuckBusy = true;
+  t = micros();
+  lcd.clear();
+  unsigned long blocked = micros() - t;
+  printf("stuck busy flag: clear() returns after %lu usec\n", blocked);
+  CHECK(blocked >= BUSY_TIMEOUT);
+  CHECK(blocked < BUSY_TIMEOUT + 2000);
+  CHECK_EQUAL(lcd.lastError(), LCD_ERROR_BUSY);
+
+  t = micros();
+  CHECK_EQUAL(lcd.waitBusy(), -1);
+  CHECK(micros() - t < BUSY_TIMEOUT + 2000);
+  CHECK_EQUAL(lcd.lastError(), LCD_ERROR_BUSY);
+  sim.stuckBusy = false;
+  CHECK(lcd.waitBusy() > 0);
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  // a read without data ends the wait at once
+  sim.shortRead = true;
+  t = micros();
+  CHECK_EQUAL(lcd.waitBusy(), -1);
+  unsigned long shortRead = micros() - t;
+  printf("short read: waitBusy() returns after %lu usec\n", shortRead);
+  CHECK(shortRead < 1000);
+  CHECK_EQUAL(lcd.lastError(), LCD_ERROR_BUSY);
+  sim.shortRead = false;
+
+  // an error does not stop the following transfers
+  lcd.setCursor(0, 0);
+  lcd.print("after");
+  CHECK_EQUAL(sim.row(0, 16), "after           ");
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  // recovery of a display that lost its state while the adapter did not answer
+  sim.nack = true;
+  sim.power();
+  lcd.print("x");
+  CHECK_EQUAL(lcd.lastError(), 2);
+  sim.nack = false;
+  t = micros();
+  lcd.begin(16, 2);
+  lcd.print("recovered");
+  printf("recovery by begin(): %lu usec\n", micros() - t);
+  CHECK_EQUAL(sim.row(0, 16), "recovered       ");
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  // A lost transmission can leave RS at another level than the driver expects, so the next transfer may change RS
+  // together with E until the display is initialized again. The violations are only counted without faults.
+  CHECK_EQUAL(sim.violations, 0);
+
+  // a data byte is not acknowledged: the display got a part of the transmission
+  recover(lcd);
+  sim.failTransmissions(LCD_FAULT_NACK_DATA, 2);
+  t = micros();
+  lcd.setCursor(0, 0);
+  lcd.print(screen);
+  printf("data NACK: print() blocked %lu usec", micros() - t);
+  CHECK_EQUAL(lcd.lastError(), 3);
+  CHECK(sim.row(0, 16) != screen);
+  unsigned long back = recover(lcd);
+  printf(", correct screen after %lu usec\n", back);
+  CHECK_EQUAL(sim.row(0, 16), screen);
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  // the transmission that raises E for the busy flag is not acknowledged: waitBusy() gives up at once
+  sim.failTransmissions(LCD_FAULT_NACK_DATA, 1);
+  t = micros();
+  CHECK_EQUAL(lcd.waitBusy(), -1);
+  CHECK(micros() - t < 1000);
+  CHECK_EQUAL(lcd.lastError(), 3);
+  sim.failTransmissions(LCD_FAULT_NACK_ADDRESS, 1);
+  CHECK_EQUAL(lcd.waitBusy(), -1);
+  CHECK_EQUAL(lcd.lastError(), 2);
+  recover(lcd);
+  CHECK_EQUAL(sim.row(0, 16), screen);
+
+  // a timeout of the Wire library blocks for its timeout once
+  sim.failTransmissions(LCD_FAULT_TIMEOUT, 2);
+  t = micros();
+  lcd.setCursor(0, 0);
+  lcd.print(screen);
+  unsigned long blockedTimeout = micros() - t;
+  back = recover(lcd);
+  printf("timeout: print() blocked %lu usec, correct screen after %lu usec\n", blockedTimeout, back);
+  CHECK(blockedTimeout >= LCD_SIM_WIRE_TIMEOUT);
+  CHECK(blockedTimeout < LCD_SIM_WIRE_TIMEOUT + 5000);
+  CHECK_EQUAL(lcd.lastError(), 5);
+  CHECK_EQUAL(sim.row(0, 16), screen);
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  sim.failTransmissions(LCD_FAULT_TIMEOUT, 1);
+  t = micros();
+  CHECK_EQUAL(lcd.waitBusy(), -1);
+  CHECK(micros() - t < LCD_SIM_WIRE_TIMEOUT + 1000);
+  CHECK_EQUAL(lcd.lastError(), 5);
+
+  // a stuck bus for 100 msec: every transmission waits for the timeout until the bus is free again
+  sim.failFor(LCD_FAULT_TIMEOUT, 100000);
+  t = micros();
+  lcd.clear();
+  lcd.print(screen);
+  unsigned long blockedStuck = micros() - t;
+  CHECK(blockedStuck >= 100000);
+  CHECK(blockedStuck < 100000 + LCD_SIM_WIRE_TIMEOUT + 2000);
+  CHECK_EQUAL(lcd.lastError(), 5);
+  back = recover(lcd);
+  printf("stuck bus for 100000 usec: clear() and print() blocked %lu usec, correct screen after %lu usec\n", blockedStuck, back);
+  CHECK_EQUAL(sim.row(0, 16), screen);
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  // the busy flag is read as set: waitBusy() polls until the reads are right again
+  sim.flipMask = 0x80; // D7
+  sim.failFor(LCD_FAULT_FLIP, 2000);
+  t = micros();
+  int polls = lcd.waitBusy();
+  printf("busy flag flipped for 2000 usec: waitBusy() blocked %lu usec\n", micros() - t);
+  CHECK(polls > 1);
+  CHECK(micros() - t >= 2000);
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  // ... or until the timeout
+  sim.failFor(LCD_FAULT_FLIP, 2 * BUSY_TIMEOUT);
+  t = micros();
+  CHECK_EQUAL(lcd.waitBusy(), -1);
+  CHECK(micros() - t < BUSY_TIMEOUT + 2000);
+  CHECK_EQUAL(lcd.lastError(), LCD_ERROR_BUSY);
+  sim.clearFaults();
+
+  // the busy flag is read as clear while the display is busy: the driver cannot detect it,
+  // the next instruction is lost and only a check of the screen finds it.
+  unsigned long busyWrites = sim.busyWrites;
+  sim.failTransmissions(LCD_FAULT_FLIP, 1, 1000);
+  lcd.clear();
+  lcd.print("x");
+  sim.clearFaults();
+  CHECK_EQUAL(lcd.lastError(), 0);
+  CHECK(sim.busyWrites > busyWrites);
+  recover(lcd);
+  CHECK_EQUAL(sim.row(0, 16), screen);
+  sim.busyWrites = busyWrites;
+
+  // a fault of the nth transmission of a sequence, the faults before are counted
+  unsigned long faults = sim.faults;
+  sim.failTransmissions(LCD_FAULT_NACK_ADDRESS, 3, 2);
+  lcd.setCursor(0, 1);
+  lcd.print("abcdefghijklmnop");
+  CHECK_EQUAL(sim.faults - faults, 2);
+  CHECK_EQUAL(lcd.lastError(), 2);
+  recover(lcd);
+  CHECK_EQUAL(sim.row(0, 16), screen);
+
+  // no faults after the recovery
+  unsigned long violations = sim.violations;
+  lcd.setCursor(0, 1);
+  lcd.print(screen);
+  lcd.clear();
+  CHECK_EQUAL(sim.violations, violations);
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  // a display without adapter
+  LiquidCrystal_PCF8574 missing(0x20);
+  missing.begin(16, 2);
+  CHECK_EQUAL(missing.lastError(), 2);
+
+  return test_result("test_errors");
+}
@@ -0,0 +1,110 @@
+// Test of the frame exchange between a producer thread and a consumer thread.
+//
+// The producer publishes numbered frames as fast as it can until the consumer has sent enough of them.
+// Every character of a frame depends on its number, so the display shows a torn frame when two frames were mixed.
+// The consumer sends the frames to the simulated display and checks after every flush() that the display shows
+// a complete frame that is not older than the newest frame published before the flush() started.
+// Run it with "make SANITIZE=thread" to check the memory ordering.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+#include <LiquidCrystal_PCF8574_Exchange.h>
+#include <atomic>
+#include <thread>
+
+#define COLS 16
+#define ROWS 2
+#define FLUSHES 200UL // frames sent by the consumer while the producer is running
+
+static std::atomic<unsigned long> published(0); ///< number of the newest published frame
+static std::atomic<unsigned long> flushes(0); ///< frames sent by the consumer
+static std::atomic<bool> finished(false);
+
+// the frame number in hex followed by characters that depend on it.
+static void draw(uint8_t *frame, unsigned long number)
+{
+  char hex[9];
+  snprintf(hex, sizeof(hex), "%08lX", number);
+  memcpy(frame, hex, 8);
+  for (uint8_t i = 8; i < COLS * ROWS; i++)
+    frame[i] = 'a' + (number + i) % 26;
+}
+
+
+// the number of the frame on the display, -1 when it is torn.
+static long shown(LcdSim &sim)
+{
+  uint8_t frame[COLS * ROWS];
+  uint8_t expected[COLS * ROWS];
+  std::string text = sim.row(0, COLS) + sim.row(1, COLS);
+
+  memcpy(frame, text.data(), sizeof(frame));
+  unsigned long number = strtoul(text.substr(0, 8).c_str(), NULL, 16);
+  draw(expected, number);
+  return (memcmp(frame, expected, sizeof(frame)) == 0) ? (long)number : -1;
+}
+
+
+static void producer(LiquidCrystal_PCF8574_Exchange *exchange)
+{
+  for (unsigned long n = 1; flushes < FLUSHES; n++) {
+    draw(exchange->frame(), n);
+    exchange->publish();
+    published.store(n, std::memory_order_release);
+  }
+  finished = true;
+}
+
+
+int main()
+{
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  static uint8_t frames[LCD_EXCHANGE_SIZE(COLS, ROWS)];
+  LiquidCrystal_PCF8574_Exchange exchange(lcd, COLS, ROWS, frames);
+  unsigned long torn = 0, stale = 0, backwards = 0;
+  long last = 0;
+
+  lcd.begin(COLS, ROWS);
+  draw(exchange.frame(), 0);
+  exchange.publish();
+  exchange.flush();
+  CHECK_EQUAL(shown(sim), 0);
+
+  // the consumer runs in its own thread like the render task of the DualCore example
+  std::thread render([&]() {
+    bool done = false;
+    while (!done) {
+      done = finished;
+      unsigned long newest = published.load(std::memory_order_acquire);
+      if (exchange.flush())
+        flushes++;
+      long number = shown(sim);
+      if (number < 0)
+        torn++;
+      else if ((unsigned long)number < newest)
+        stale++;
+      else if (number < last)
+        backwards++;
+      if (number >= 0)
+        last = number;
+    }
+  });
+  std::thread application(producer, &exchange);
+  application.join();
+  render.join();
+
+  printf("%lu frames published, %lu sent\n", published.load(), flushes.load());
+  CHECK_EQUAL(torn, 0);
+  CHECK_EQUAL(stale, 0);
+  CHECK_EQUAL(backwards, 0);
+  CHECK_EQUAL(shown(sim), published);
+  CHECK_EQUAL(sim.violations, 0);
+
+  // nothing new: flush() does not use the bus
+  unsigned long transmissions = simBus.transmissions;
+  CHECK(!exchange.flush());
+  CHECK_EQUAL(simBus.transmissions, transmissions);
+  return test_result("test_exchange");
+}
@@ -0,0 +1,92 @@
+// Test of the glyph manager: uploads and preloads of the character generator RAM in every entry mode.
+//
+// The display writes the character generator RAM in the entry mode like the display RAM. An upload while the
+// application writes right to left must still fill the slot from its first row and must not touch the other slots.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+#include <LiquidCrystal_PCF8574_Glyphs.h>
+
+#define GLYPHS 12
+
+static uint8_t glyphs[GLYPHS][8];
+
+
+// the CGRAM slots hold the glyphs the manager has put there.
+static void checkSlots(LcdSim &sim, LiquidCrystal_PCF8574_Glyphs &cgram)
+{
+  for (uint8_t g = 0; g < GLYPHS; g++) {
+    uint8_t s = cgram.slot(g);
+    if (s == LCD_GLYPH_NONE)
+      continue;
+    for (uint8_t i = 0; i < 8; i++)
+      CHECK_EQUAL(sim.cgram(s * 8 + i), glyphs[g][i]);
+  }
+}
+
+
+int main()
+{
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  LiquidCrystal_PCF8574_Glyphs cgram(lcd, glyphs, GLYPHS);
+  const uint8_t current[] = { 0, 1, 2, 3 };
+  const uint8_t next[] = { 4, 5, 6, 7 };
+  const uint8_t other[] = { 8, 9, 10, 11 };
+
+  // every row of every glyph is different
+  for (uint8_t g = 0; g < GLYPHS; g++) {
+    for (uint8_t i = 0; i < 8; i++)
+      glyphs[g][i] = (g * 8 + i + 1) & 0x1F;
+  }
+
+  lcd.begin(16, 2);
+  CHECK(cgram.use(current, 4));
+  checkSlots(sim, cgram);
+
+  // the application writes right to left from the end of the first row
+  lcd.rightToLeft();
+  lcd.setCursor(15, 0);
+  lcd.write(cgram.slot(0));
+  lcd.write(cgram.slot(1));
+  cgram.hint(next, 4);
+  while (cgram.idle())
+    checkSlots(sim, cgram);
+  for (uint8_t n = 0; n < 4; n++)
+    CHECK(cgram.slot(next[n]) != LCD_GLYPH_NONE);
+  checkSlots(sim, cgram);
+
+  // the entry mode and the cursor position are kept
+  CHECK_EQUAL(sim.entryMode(), 0x00);
+  CHECK_EQUAL(sim.ac(), 13);
+  lcd.write(cgram.slot(2));
+  CHECK_EQUAL(sim.ddram(15), cgram.slot(0));
+  CHECK_EQUAL(sim.ddram(14), cgram.slot(1));
+  CHECK_EQUAL(sim.ddram(13), cgram.slot(2));
+
+  // the same with autoscroll: the display does not shift while a glyph is uploaded
+  lcd.autoscroll();
+  uint8_t shift = sim.shift();
+  CHECK(cgram.use(next, 4));
+  cgram.hint(other, 4);
+  while (cgram.idle())
+    checkSlots(sim, cgram);
+  checkSlots(sim, cgram);
+  CHECK_EQUAL(sim.shift(), shift);
+  CHECK_EQUAL(sim.entryMode(), 0x01);
+  CHECK_EQUAL(sim.ac(), 12);
+
+  // createChar() in right to left mode writes the whole slot
+  lcd.noAutoscroll();
+  byte bar[8] = { 0x1F, 0x1E, 0x1C, 0x18, 0x10, 0x11, 0x13, 0x17 };
+  lcd.createChar(5, bar);
+  for (uint8_t i = 0; i < 8; i++)
+    CHECK_EQUAL(sim.cgram(5 * 8 + i), bar[i]);
+  CHECK_EQUAL(sim.entryMode(), 0x00);
+
+  CHECK_EQUAL(sim.violations, 0);
+  CHECK_EQUAL(sim.busyWrites, 0);
+  CHECK_EQUAL(lcd.lastError(), 0);
+  return test_result("test_glyphs");
+}
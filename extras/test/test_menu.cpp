@@ -0,0 +1,289 @@
+// Test of the menu: random moves of the selection compared with the expected view and the cells that are rewritten.
+//
+// After every move the rows on the display must show the items from the top item with the marker in front of the
+// selection. Only cells that change may be written, except a single unchanged cell between two changed ones,
+// and every changed cell must be written exactly once.
+// With prefetch() the hidden page is prepared in between: it must not touch the visible cells, and a scroll to the
+// prepared view only switches the page.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+#include <LiquidCrystal_PCF8574_Menu.h>
+
+#define SEED 20261018UL
+#define MOVES 2000
+#define ITEMS 12
+
+static const char *const items[ITEMS] PROGMEM = {
+  "Settings", "Information", "Network", "Display", "Sound", "",
+  "Power", "Clock", "About", "Set time", "Set date", "A very long item text that is wider than a display line"
+};
+
+static unsigned long rnd_state;
+
+// a small LCG so the sequence does not depend on the C library
+static unsigned int rnd(unsigned int n)
+{
+  rnd_state = rnd_state * 1103515245UL + 12345UL;
+  return ((rnd_state >> 16) & 0x7FFF) % n;
+}
+
+
+/// A display size and the menu on it.
+struct Size {
+  const char *name;
+  uint8_t cols, rows;
+};
+
+
+// the display RAM address of a visible cell
+static uint8_t address(LcdSim &sim, uint8_t rows, uint8_t col, uint8_t row)
+{
+  static const uint8_t base[4] = { 0x00, 0x40, 0x14, 0x54 };
+  if (rows <= 1)
+    return (col + sim.shift()) % 80;
+  return (base[row] & 0x40) | (((base[row] & 0x3F) + col + sim.shift()) % 40);
+}
+
+
+// a row of the view with the given top item and selection
+static std::string expectedRow(uint8_t cols, uint8_t top, uint8_t selected, uint8_t row)
+{
+  std::string s(cols, ' ');
+  uint8_t item = top + row;
+
+  if (item == selected)
+    s[0] = '>';
+  if (item < ITEMS) {
+    const char *text = items[item];
+    for (uint8_t i = 0; (i + 1 < cols) && text[i]; i++)
+      s[i + 1] = text[i];
+  }
+  return s;
+}
+
+
+// a row of a page in the display RAM
+static std::string pageRow(LcdSim &sim, const Size &f, uint8_t page, uint8_t row)
+{
+  static const uint8_t base[4] = { 0x00, 0x40, 0x14, 0x54 };
+  uint8_t offset = (f.rows > 1) ? 20 : 40;
+  std::string s;
+  for (uint8_t col = 0; col < f.cols; col++)
+    s += (char)sim.ddram(base[row] + page * offset + col);
+  return s;
+}
+
+
+// the display shows the view and only the changed cells were written. After a page switch no visible cell is written.
+static bool checkView(LcdSim &sim, const Size &f, uint8_t top, uint8_t selected, const std::string *before,
+  bool switched, unsigned long n)
+{
+  bool ok = true;
+
+  for (uint8_t r = 0; r < f.rows; r++) {
+    std::string row = expectedRow(f.cols, top, selected, r);
+    ok &= CHECK_EQUAL(sim.row(r, f.cols), row);
+    for (uint8_t col = 0; col < f.cols; col++) {
+      unsigned long writes = sim.ddramWrites[address(sim, f.rows, col, r)];
+      bool changed = (before[r][col] != row[col]);
+      if (switched) {
+        ok &= CHECK_EQUAL(writes, 0);
+      } else if (changed) {
+        ok &= CHECK_EQUAL(writes, 1);
+      } else if (writes) {
+        // a single unchanged cell within a run of changes
+        ok &= CHECK_EQUAL(writes, 1);
+        ok &= CHECK((col > 0) && (col + 1 < f.cols));
+        ok &= CHECK((before[r][col - 1] != row[col - 1]) && (before[r][col + 1] != row[col + 1]));
+      }
+    }
+  }
+  ok &= CHECK_EQUAL(sim.violations, 0);
+  ok &= CHECK_EQUAL(sim.busyWrites, 0);
+  if (!ok)
+    printf("%s: after move %lu of the sequence with seed %lu\n", f.name, n, SEED);
+  return ok;
+}
+
+
+static void moves(const Size &f, bool prefetch)
+{
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  LiquidCrystal_PCF8574_Menu menu(lcd, items, ITEMS, f.cols, f.rows);
+  std::string before[4];
+  uint8_t top = 0, selected = 0;
+  unsigned long switches = 0;
+
+  rnd_state = SEED;
+  lcd.begin(f.cols, f.rows);
+  menu.draw();
+  for (uint8_t r = 0; r < f.rows; r++) {
+    CHECK_EQUAL(sim.row(r, f.cols), expectedRow(f.cols, 0, 0, r));
+    for (uint8_t col = 0; col < f.cols; col++)
+      CHECK_EQUAL(sim.ddramWrites[address(sim, f.rows, col, r)], 1);
+  }
+
+  for (unsigned long n = 1; n <= MOVES; n++) {
+    for (uint8_t r = 0; r < f.rows; r++)
+      before[r] = sim.row(r, f.cols);
+    memset(sim.ddramWrites, 0, sizeof(sim.ddramWrites));
+
+    // the application is idle for some calls of prefetch()
+    if (prefetch) {
+      for (uint8_t i = rnd(f.rows + 3); i > 0; i--)
+        menu.prefetch();
+      bool ok = true;
+      for (uint8_t r = 0; r < f.rows; r++) {
+        ok &= CHECK_EQUAL(sim.row(r, f.cols), before[r]);
+        for (uint8_t col = 0; col < f.cols; col++)
+          ok &= CHECK_EQUAL(sim.ddramWrites[address(sim, f.rows, col, r)], 0);
+      }
+      if (!ok) {
+        printf("%s: prefetch before move %lu of the sequence with seed %lu\n", f.name, n, SEED);
+        return;
+      }
+      memset(sim.ddramWrites, 0, sizeof(sim.ddramWrites));
+    }
+    uint8_t shift = sim.shift();
+
+    switch (rnd(4)) {
+      case 0:
+        menu.next();
+        if (selected + 1 < ITEMS)
+          selected++;
+        break;
+      case 1:
+        menu.prev();
+        if (selected > 0)
+          selected--;
+        break;
+      default: {
+        uint8_t item = rnd(ITEMS + 2);
+        menu.select(item);
+        if (item < ITEMS)
+          selected = item;
+        break;
+      }
+    }
+    // the menu scrolls as little as possible
+    if (selected < top)
+      top = selected;
+    else if (selected >= top + f.rows)
+      top = selected - f.rows + 1;
+
+    CHECK_EQUAL(menu.selected(), selected);
+    CHECK_EQUAL(menu.top(), top);
+    bool switched = (sim.shift() != shift);
+    if (switched)
+      switches++;
+    if (!checkView(sim, f, top, selected, before, switched, n))
+      return;
+  }
+  // a menu with a hidden page scrolls by page switches
+  if (prefetch && (f.rows <= 2))
+    CHECK(switches > MOVES / 20);
+  if (!prefetch)
+    CHECK_EQUAL(switches, 0);
+  CHECK_EQUAL(lcd.lastError(), 0);
+} // moves()
+
+
+int main()
+{
+  Size sizes[] = { { "16x2", 16, 2 }, { "20x4", 20, 4 }, { "40x1", 40, 1 } };
+  for (uint8_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+    moves(sizes[n], false);
+    moves(sizes[n], true);
+  }
+
+  // moving the selection within the view only rewrites the two marker cells
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  LiquidCrystal_PCF8574_Menu menu(lcd, items, ITEMS, 20, 4);
+  lcd.begin(20, 4);
+  menu.draw();
+  unsigned long c = sim.characters;
+  menu.next();
+  menu.next();
+  CHECK_EQUAL(sim.characters - c, 4);
+  CHECK_EQUAL(sim.row(2, 20), ">Network            ");
+
+  // scrolling by one row rewrites only the characters that differ
+  c = sim.characters;
+  menu.select(4);
+  CHECK_EQUAL(sim.row(0, 20), " Information        ");
+  CHECK_EQUAL(sim.row(3, 20), ">Sound              ");
+  CHECK(sim.characters - c < 4 * 19);
+
+  // prefetch() prepares the next view in the hidden page, one row per call
+  Size f = { "16x2", 16, 2 };
+  LcdSim sim2(0x26);
+  LiquidCrystal_PCF8574 lcd2(0x26);
+  LiquidCrystal_PCF8574_Menu menu2(lcd2, items, ITEMS, 16, 2);
+  lcd2.begin(16, 2);
+  menu2.draw();
+  unsigned long t = sim2.transmissions;
+  unsigned long busy = simBus.busyTime;
+  menu2.draw();
+  unsigned long full = sim2.transmissions - t;
+  unsigned long fullTime = simBus.busyTime - busy;
+
+  menu2.next();
+  uint8_t calls = 0;
+  while (menu2.prefetch())
+    calls++;
+  CHECK_EQUAL(calls, 2);
+  CHECK_EQUAL(pageRow(sim2, f, 1, 0), expectedRow(16, 1, 2, 0));
+  CHECK_EQUAL(pageRow(sim2, f, 1, 1), expectedRow(16, 1, 2, 1));
+  CHECK_EQUAL(sim2.row(0, 16), expectedRow(16, 0, 1, 0));
+
+  // scrolling down switches to the prepared page with fewer transmissions than a redraw
+  t = sim2.transmissions;
+  unsigned long chars = sim2.characters;
+  menu2.next();
+  unsigned long forward = sim2.transmissions - t;
+  CHECK_EQUAL(lcd2.visiblePage(), 1);
+  CHECK_EQUAL(sim2.characters - chars, 0);
+  CHECK_EQUAL(sim2.row(0, 16), expectedRow(16, 1, 2, 0));
+  CHECK_EQUAL(sim2.row(1, 16), expectedRow(16, 1, 2, 1));
+  CHECK(forward < full);
+
+  // the selection goes up, the view above is prepared in page 0 and scrolling up returns to it
+  menu2.prev();
+  calls = 0;
+  while (menu2.prefetch())
+    calls++;
+  CHECK(calls > 0);
+  CHECK_EQUAL(pageRow(sim2, f, 0, 0), expectedRow(16, 0, 0, 0));
+  CHECK_EQUAL(pageRow(sim2, f, 0, 1), expectedRow(16, 0, 0, 1));
+  // the Return home needs 1.52 msec, the reads of the busy flag take more transmissions but less bus time than a redraw
+  t = sim2.transmissions;
+  busy = simBus.busyTime;
+  chars = sim2.characters;
+  menu2.prev();
+  unsigned long back = sim2.transmissions - t;
+  unsigned long backTime = simBus.busyTime - busy;
+  CHECK_EQUAL(lcd2.visiblePage(), 0);
+  CHECK_EQUAL(sim2.characters - chars, 0);
+  CHECK_EQUAL(sim2.row(0, 16), expectedRow(16, 0, 0, 0));
+  CHECK_EQUAL(sim2.row(1, 16), expectedRow(16, 0, 0, 1));
+  CHECK(backTime < fullTime / 2);
+  printf("16x2 menu: redraw %lu transmissions in %lu usec, page switch down %lu, up %lu in %lu usec\n",
+    full, fullTime, forward, back, backTime);
+
+  // a jump to another view does not use the prepared page
+  menu2.next();
+  while (menu2.prefetch())
+    ;
+  menu2.select(8);
+  CHECK_EQUAL(lcd2.visiblePage(), 0);
+  CHECK_EQUAL(sim2.row(0, 16), expectedRow(16, 7, 8, 0));
+  CHECK_EQUAL(sim2.row(1, 16), expectedRow(16, 7, 8, 1));
+  CHECK_EQUAL(sim2.violations, 0);
+  CHECK_EQUAL(sim2.busyWrites, 0);
+
+  return test_result("test_menu");
+}
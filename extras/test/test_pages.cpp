@@ -0,0 +1,81 @@
+// Test of the display RAM pages: single displays and the switch of a group of displays.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+
+#define GROUP 8
+
+int main()
+{
+  // a single display
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  lcd.begin(16, 2);
+  CHECK_EQUAL(lcd.pageCount(), 2);
+  lcd.print("page 0");
+  lcd.writePage(1, 0, 1, (const uint8_t *)"page 1", 6);
+  CHECK_EQUAL(sim.row(0, 16), "page 0          ");
+
+  lcd.showPage(1);
+  CHECK_EQUAL(lcd.visiblePage(), 1);
+  CHECK_EQUAL(sim.shift(), 20);
+  CHECK_EQUAL(sim.row(1, 16), "page 1          ");
+  lcd.showPage(0);
+  CHECK_EQUAL(sim.shift(), 0);
+  CHECK_EQUAL(sim.row(0, 16), "page 0          ");
+
+  // a group of displays switches at practically the same time
+  LcdSim *sims[GROUP];
+  LiquidCrystal_PCF8574 *displays[GROUP];
+  for (uint8_t n = 0; n < GROUP; n++) {
+    sims[n] = new LcdSim(0x30 + n);
+    displays[n] = new LiquidCrystal_PCF8574(0x30 + n);
+  }
+  LiquidCrystal_PCF8574::begin(displays, GROUP, 16, 2);
+  for (uint8_t n = 0; n < GROUP; n++) {
+    uint8_t text[] = { 'p', 'a', 'n', 'e', 'l', ' ', (uint8_t)('0' + n) };
+    displays[n]->writePage(1, 0, 0, text, sizeof(text));
+  }
+  // one display is shifted already, it needs fewer instructions
+  displays[3]->scrollDisplayLeft();
+
+  unsigned long start = micros();
+  unsigned long transmissions = simBus.transmissions;
+  LiquidCrystal_PCF8574::showPage(displays, GROUP, 1);
+  transmissions = simBus.transmissions - transmissions;
+  unsigned long first = (unsigned long)-1, last = 0;
+  for (uint8_t n = 0; n < GROUP; n++) {
+    char expected[17];
+    snprintf(expected, sizeof(expected), "panel %d         ", n);
+    CHECK_EQUAL(sims[n]->row(0, 16), expected);
+    CHECK_EQUAL(displays[n]->visiblePage(), 1);
+    if (sims[n]->shiftTime < first) first = sims[n]->shiftTime;
+    if (sims[n]->shiftTime > last) last = sims[n]->shiftTime;
+  }
+  printf("group of %d: page 1 after %lu usec in %lu transmissions, within %lu usec\n", GROUP, last - start, transmissions, last - first);
+  // 20 shift instructions of 4 bytes per display: 3 transmissions of up to 7 instructions and the last instruction.
+  // The time is the time of these bytes, 4 address bytes and one byte for the RS line per display.
+  CHECK_EQUAL(transmissions, GROUP * 4);
+  CHECK(last - start <= GROUP * (20 * 4 + 4 + 1) * LCD_SIM_BYTE_TIME);
+  // the last instruction of every display is part of the same round
+  CHECK(last - first < GROUP * 5 * LCD_SIM_BYTE_TIME);
+
+  start = micros();
+  LiquidCrystal_PCF8574::showPage(displays, GROUP, 0);
+  first = (unsigned long)-1;
+  last = 0;
+  for (uint8_t n = 0; n < GROUP; n++) {
+    CHECK_EQUAL(sims[n]->shift(), 0);
+    CHECK_EQUAL(sims[n]->busyWrites, 0);
+    CHECK_EQUAL(sims[n]->violations, 0);
+    if (sims[n]->shiftTime < first) first = sims[n]->shiftTime;
+    if (sims[n]->shiftTime > last) last = sims[n]->shiftTime;
+  }
+  printf("group of %d: page 0 after %lu usec, within %lu usec\n", GROUP, last - start, last - first);
+  CHECK(last - first < GROUP * 5 * LCD_SIM_BYTE_TIME);
+
+  CHECK_EQUAL(sim.violations, 0);
+  CHECK_EQUAL(simBus.overflows, 0);
+  return test_result("test_pages");
+}
@@ -0,0 +1,166 @@
+// Test of the frame sequence player: decoding from PROGMEM and streams, rejected sequences and records.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574_Player.h>
+#include <vector>
+
+// a sequence in the format of extras/frames/lcd_frames.py
+struct Sequence {
+  std::vector<uint8_t> data;
+
+  Sequence(uint8_t cols, uint8_t rows, uint16_t frames, uint16_t period)
+  {
+    uint8_t h[] = { 'L', 'F', cols, rows, (uint8_t)frames, (uint8_t)(frames >> 8), (uint8_t)period, (uint8_t)(period >> 8) };
+    data.assign(h, h + sizeof(h));
+  }
+  void run(uint8_t pos, const char *text)
+  {
+    data.push_back(0x02);
+    data.push_back(pos);
+    data.push_back(strlen(text));
+    data.insert(data.end(), text, text + strlen(text));
+  }
+  void glyph(uint8_t slot, const uint8_t *bits)
+  {
+    data.push_back(0x01);
+    data.push_back(slot);
+    data.insert(data.end(), bits, bits + 8);
+  }
+  void end() { data.push_back(0x00); }
+};
+
+class MemoryStream : public Stream
+{
+public:
+  MemoryStream(const std::vector<uint8_t> &data) : _data(data), _pos(0) {}
+  virtual int available() { return _data.size() - _pos; }
+  virtual int read() { return (_pos < _data.size()) ? _data[_pos++] : -1; }
+  virtual int peek() { return (_pos < _data.size()) ? _data[_pos] : -1; }
+  virtual size_t write(uint8_t) { return 0; }
+
+private:
+  const std::vector<uint8_t> &_data;
+  size_t _pos;
+};
+
+static const uint8_t heart[8] = { 0x00, 0x0A, 0x1F, 0x1F, 0x0E, 0x04, 0x00, 0x00 };
+
+// three frames: complete screen, two changed characters, a custom character
+static Sequence animation()
+{
+  Sequence s(16, 2, 3, 100);
+  s.run(0, "Frame sequence  ");
+  s.run(16, "counter: 00     ");
+  s.end();
+  s.run(25, "01");
+  s.end();
+  s.glyph(3, heart);
+  s.run(25, "02 \x03");
+  s.end();
+  return s;
+}
+
+
+static void play(LiquidCrystal_PCF8574_Player &player, LcdSim &sim)
+{
+  CHECK_EQUAL(player.frameCount(), 3);
+  CHECK_EQUAL(player.period(), 100);
+
+  CHECK(player.update());
+  CHECK_EQUAL(sim.row(0, 16), "Frame sequence  ");
+  CHECK_EQUAL(sim.row(1, 16), "counter: 00     ");
+
+  // nothing happens before the period has elapsed
+  unsigned long t = simBus.transmissions;
+  delay(50);
+  CHECK(player.update());
+  CHECK_EQUAL(simBus.transmissions - t, 0);
+
+  delay(50);
+  t = simBus.transmissions;
+  CHECK(player.update());
+  CHECK_EQUAL(sim.row(1, 16), "counter: 01     ");
+  CHECK_EQUAL(simBus.transmissions - t, 2); // address and two characters
+
+  delay(100);
+  CHECK(player.update());
+  CHECK_EQUAL(sim.row(1, 16), "counter: 02 3   ");
+  CHECK_EQUAL(sim.cgram(3 * 8 + 2), 0x1F);
+  CHECK_EQUAL(player.frame(), 3);
+
+  delay(100);
+  CHECK(!player.update());
+}
+
+
+int main()
+{
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  lcd.begin(16, 2);
+
+  Sequence seq = animation();
+  uint8_t buffer[64];
+
+  // from PROGMEM with a buffer for complete frames
+  LiquidCrystal_PCF8574_Player player(lcd, buffer, sizeof(buffer));
+  CHECK(player.begin(seq.data.data(), seq.data.size()));
+  play(player, sim);
+
+  // from a stream with the smallest buffer, frames are completed directly from the source
+  lcd.clear();
+  MemoryStream stream(seq.data);
+  LiquidCrystal_PCF8574_Player small(lcd, buffer, 3 + 16);
+  CHECK(small.begin(stream));
+  play(small, sim);
+
+  // the buffer must hold a row
+  LiquidCrystal_PCF8574_Player tiny(lcd, buffer, 3 + 15);
+  CHECK(!tiny.begin(seq.data.data(), seq.data.size()));
+
+  // sequences that do not fit on the display
+  Sequence wide(20, 2, 1, 100);
+  CHECK(!player.begin(wide.data.data(), wide.data.size()));
+  Sequence high(16, 4, 1, 100);
+  CHECK(!player.begin(high.data.data(), high.data.size()));
+  Sequence empty(16, 0, 1, 100);
+  CHECK(!player.begin(empty.data.data(), empty.data.size()));
+
+  // a smaller sequence is shown at the top left
+  lcd.clear();
+  Sequence part(8, 1, 1, 100);
+  part.run(0, "12345678");
+  part.end();
+  CHECK(player.begin(part.data.data(), part.data.size()));
+  CHECK(player.update());
+  CHECK_EQUAL(sim.row(0, 16), "12345678        ");
+
+  // runs outside of the sequence or across the end of a row stop the frame and write nothing
+  for (int direct = 0; direct < 2; direct++) {
+    lcd.clear();
+    Sequence bad(16, 2, 2, 100);
+    bad.run(0, "first");
+    bad.run(32, "outside");
+    bad.run(16, "never");
+    bad.end();
+    bad.run(14, "abcd");
+    bad.end();
+
+    LiquidCrystal_PCF8574_Player p(lcd, buffer, direct ? 3 + 16 : sizeof(buffer));
+    CHECK(p.begin(bad.data.data(), bad.data.size()));
+    p.update();
+    delay(100);
+    p.update();
+    CHECK_EQUAL(sim.row(0, 16), "first           ");
+    CHECK_EQUAL(sim.row(1, 16), "                ");
+    for (uint8_t a = 0; a < 0x68; a++) {
+      if (a >= 5)
+        CHECK_EQUAL(sim.ddram(a), ' ');
+    }
+  }
+
+  CHECK_EQUAL(sim.violations, 0);
+  CHECK_EQUAL(simBus.overflows, 0);
+  return test_result("test_player");
+}
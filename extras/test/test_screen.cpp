@@ -0,0 +1,229 @@
+// Test of the screen templates: drawing, refresh of changed characters, the size of the cache and the latency statistics.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574_Screen.h>
+#include <limits.h>
+
+int temp = 215;
+long count = 0;
+char name[4] = "abc";
+
+const char layout[] PROGMEM = "Temp:      C\nCount:";
+const char wideLayout[] PROGMEM = "0123456789abcdefghij\nklmnopqrstuvwxyzABCD";
+const LiquidCrystal_PCF8574_Field fields[] PROGMEM = {
+  { 6, 0, 5, LCD_FIELD_INT, 1, &temp, 0 },
+  { 7, 1, 8, LCD_FIELD_LONG, 0, &count, 0 },
+  { 13, 0, 3, LCD_FIELD_STRING, 0, name, 0 }
+};
+
+long wide = 0;
+long small1 = 0;
+long small2 = 0;
+const LiquidCrystal_PCF8574_Field budgetFields[] PROGMEM = {
+  { 0, 0, 8, LCD_FIELD_LONG, 0, &wide, 0 },
+  { 10, 0, 3, LCD_FIELD_LONG, 0, &small1, 0 },
+  { 0, 1, 3, LCD_FIELD_LONG, 0, &small2, 1 }
+};
+
+
+// refresh with a budget that is smaller than the change of a field
+static void testBudget(LiquidCrystal_PCF8574 &lcd, LcdSim &sim, bool stats)
+{
+  char cache[14];
+  LiquidCrystal_PCF8574_Latency latency[3];
+  LiquidCrystal_PCF8574_Screen screen(lcd, "", budgetFields, 3, cache, sizeof(cache));
+  if (stats)
+    screen.setLatencyStats(latency);
+  lcd.clear();
+  wide = small1 = small2 = 0;
+  screen.draw();
+
+  // the wide field changes first and is the oldest change
+  wide = 12345678;
+  screen.changed(0);
+  delay(1);
+  small1 = 111;
+  small2 = 222;
+  screen.changed(1);
+  screen.changed(2);
+
+  screen.refresh(4);
+  CHECK_EQUAL(sim.row(0, 16), "12345678    0   ");
+  screen.refresh(4);
+  screen.refresh(4);
+  CHECK_EQUAL(sim.row(0, 16), "12345678  111   ");
+  CHECK_EQUAL(sim.row(1, 16), "222             ");
+  if (stats)
+    CHECK_EQUAL(screen.oldestPending(), 0);
+
+  // a field that does not fit into the rest of the budget is skipped, the next one is sent
+  wide = 87654321;
+  small1 = 115;
+  small2 = 6;
+  screen.changed(1);
+  delay(1);
+  screen.changed(0);
+  screen.changed(2);
+  screen.refresh(4);
+  if (stats) {
+    CHECK_EQUAL(sim.row(0, 16), "12345678  115   ");
+    CHECK_EQUAL(sim.row(1, 16), "  6             ");
+  } else {
+    // from the top left the wide field comes first
+    CHECK_EQUAL(sim.row(0, 16), "87654321  111   ");
+    CHECK_EQUAL(sim.row(1, 16), "222             ");
+  }
+}
+
+
+// refresh() a field after a delay of ms milliseconds and return the latency from changed() to the end of the transmission
+static unsigned long change(LiquidCrystal_PCF8574_Screen &screen, unsigned long ms)
+{
+  unsigned long start = micros();
+  temp++;
+  screen.changed(0);
+  delay(ms);
+  screen.refresh();
+  return micros() - start;
+}
+
+
+// latencyMax() and latencyPercentile() report the upper bound of the histogram bucket of a percentile
+static void testLatency(LiquidCrystal_PCF8574 &lcd, LcdSim &sim)
+{
+  char cache[16];
+  LiquidCrystal_PCF8574_Latency latency[3];
+  LiquidCrystal_PCF8574_Screen screen(lcd, layout, fields, 3, cache, sizeof(cache));
+
+  // without statistics and for fields that do not exist nothing is reported
+  CHECK_EQUAL(screen.latencyMax(0), 0);
+  CHECK_EQUAL(screen.latencyPercentile(0, 50), 0);
+  screen.setLatencyStats(latency);
+  lcd.clear();
+  screen.draw();
+  CHECK_EQUAL(screen.latencyMax(0), 0);
+  CHECK_EQUAL(screen.latencyPercentile(0, 50), 0);
+  CHECK_EQUAL(screen.latencyMax(3), 0);
+  CHECK_EQUAL(screen.latencyPercentile(3, 50), 0);
+
+  // a single sample: the bucket bound is limited by the maximum. Sending the changed digit takes about 1 msec.
+  unsigned long single = change(screen, 0);
+  CHECK((single >= 1000) && (single < 2000));
+  CHECK_EQUAL(screen.latencyMax(0), single);
+  CHECK_EQUAL(screen.latencyPercentile(0, 50), single);
+  CHECK_EQUAL(screen.latencyMax(1), 0);
+
+  // 8 samples in 2..4 msec, one in 32..64 msec and one above 128 msec
+  screen.resetLatency();
+  CHECK_EQUAL(screen.latencyMax(0), 0);
+  for (int n = 0; n < 8; n++) {
+    unsigned long l = change(screen, 1);
+    CHECK((l >= 2000) && (l < 4000));
+  }
+  unsigned long l = change(screen, 40);
+  CHECK((l >= 32000) && (l < 64000));
+  unsigned long max = change(screen, 200);
+  CHECK(max >= 128000);
+
+  CHECK_EQUAL(screen.latencyMax(0), max);
+  CHECK_EQUAL(screen.latencyPercentile(0, 50), 4000);
+  CHECK_EQUAL(screen.latencyPercentile(0, 80), 4000);
+  CHECK_EQUAL(screen.latencyPercentile(0, 81), 64000);
+  CHECK_EQUAL(screen.latencyPercentile(0, 90), 64000);
+  CHECK_EQUAL(screen.latencyPercentile(0, 91), max);
+  CHECK_EQUAL(screen.latencyPercentile(0, 100), max);
+  CHECK_EQUAL(latency[0].histogram[3], 8);
+  CHECK_EQUAL(latency[0].histogram[LCD_LATENCY_BUCKETS - 1], 1);
+
+  // a change that is found by refresh() without changed() counts from the start of refresh()
+  temp++;
+  screen.refresh();
+  CHECK_EQUAL(latency[0].histogram[2], 1);
+  CHECK_EQUAL(screen.latencyMax(0), max);
+  CHECK_EQUAL(screen.latencyMax(1), 0);
+  CHECK_EQUAL(sim.violations, 0);
+}
+
+
+int main()
+{
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  lcd.begin(16, 2);
+
+  // all fields fit
+  char cache[16];
+  LiquidCrystal_PCF8574_Screen screen(lcd, layout, fields, 3, cache, sizeof(cache));
+  CHECK_EQUAL(screen.fieldCount(), 3);
+  screen.draw();
+  CHECK_EQUAL(sim.row(0, 16), "Temp:  21.5C abc");
+  CHECK_EQUAL(sim.row(1, 16), "Count:        0 ");
+
+  // only the changed digit is sent
+  count = 7;
+  unsigned long c = sim.characters;
+  screen.refresh();
+  CHECK_EQUAL(sim.row(1, 16), "Count:        7 ");
+  CHECK_EQUAL(sim.characters - c, 1);
+
+  c = sim.characters;
+  screen.refresh();
+  CHECK_EQUAL(sim.characters - c, 0);
+
+  // a cache for the first two fields: the third field is not shown and the cache is not overrun
+  lcd.clear();
+  char small[13 + 4];
+  memset(small, '#', sizeof(small));
+  LiquidCrystal_PCF8574_Screen partial(lcd, layout, fields, 3, small, 13);
+  CHECK_EQUAL(partial.fieldCount(), 2);
+  partial.draw();
+  strcpy(name, "xyz");
+  temp = -5;
+  partial.refresh();
+  CHECK_EQUAL(sim.row(0, 16), "Temp:  -0.5C    ");
+  for (uint8_t i = 13; i < sizeof(small); i++)
+    CHECK_EQUAL(small[i], '#');
+
+  // no field fits
+  LiquidCrystal_PCF8574_Screen none(lcd, layout, fields, 3, small, 4);
+  CHECK_EQUAL(none.fieldCount(), 0);
+  none.refresh();
+
+  // the layout is sent in chunks of one Wire transmission: 3 transmissions per row of 20 characters
+  // and a cursor instruction for the second row
+  LiquidCrystal_PCF8574 lcd20(0x26);
+  LcdSim sim20(0x26);
+  lcd20.begin(20, 2);
+  LiquidCrystal_PCF8574_Screen rows(lcd20, wideLayout, fields, 0, cache, sizeof(cache));
+  unsigned long t = sim20.transmissions;
+  rows.draw();
+  CHECK_EQUAL(sim20.row(0, 20), "0123456789abcdefghij");
+  CHECK_EQUAL(sim20.row(1, 20), "klmnopqrstuvwxyzABCD");
+  CHECK_EQUAL(sim20.transmissions - t, 1 + 2 * ((20 + LCD_CHARS_PER_TRANSMISSION - 1) / LCD_CHARS_PER_TRANSMISSION));
+
+  testLatency(lcd, sim);
+  testBudget(lcd, sim, false);
+  testBudget(lcd, sim, true);
+
+  // a very old change of a field with priority must not overflow to a low score
+  char cache2[14];
+  LiquidCrystal_PCF8574_Latency latency[3];
+  LiquidCrystal_PCF8574_Screen screen2(lcd, "", budgetFields, 3, cache2, sizeof(cache2));
+  screen2.setLatencyStats(latency);
+  lcd.clear();
+  wide = small1 = small2 = 0;
+  screen2.draw();
+  small1 = 7;
+  small2 = 8;
+  latency[1].pending = true;
+  latency[1].stamp = micros() - 1000;
+  latency[2].pending = true;
+  latency[2].stamp = micros() - (ULONG_MAX / 2 + 1);
+  screen2.refresh(1);
+  CHECK_EQUAL(sim.row(0, 16), "       0    0   ");
+  CHECK_EQUAL(sim.row(1, 16), "  8             ");
+
+  CHECK_EQUAL(sim.violations, 0);
+  return test_result("test_screen");
+}
@@ -0,0 +1,166 @@
+// Test of the SerLCD backpack mode: the bytes sent to the serial port by every function.
+//
+// Instructions are 0xFE and the HD44780 instruction, settings are '|' (0x7C) and the setting.
+// Text goes out in runs, custom characters 0..7 are shown by a setting and the characters
+// that start commands are replaced by a space. No byte may go to the I2C bus.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+
+/// A serial port that records the bytes and the calls of write().
+class SerialRecorder : public Print
+{
+public:
+  std::string bytes;
+  unsigned long writes = 0;
+
+  virtual size_t write(uint8_t c)
+  {
+    writes++;
+    bytes += (char)c;
+    return 1;
+  }
+
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    writes++;
+    bytes.append((const char *)buffer, size);
+    return size;
+  }
+
+  // the bytes since the last call as hex, text in quotes. The byte after a command prefix is always hex.
+  std::string take()
+  {
+    std::string s;
+    bool text = false;
+    for (size_t i = 0; i < bytes.size(); i++) {
+      uint8_t c = bytes[i];
+      char hex[4];
+      bool command = (i > 0) && (((uint8_t)bytes[i - 1] == 0xFE) || (bytes[i - 1] == '|'));
+      if ((c >= 0x20) && (c < 0x7F) && (c != '|') && !command) {
+        s += text ? "" : (s.empty() ? "'" : " '");
+        s += (char)c;
+        text = true;
+      } else {
+        if (text)
+          s += "'";
+        text = false;
+        snprintf(hex, sizeof(hex), s.empty() ? "%02X" : " %02X", c);
+        s += hex;
+      }
+    }
+    if (text)
+      s += "'";
+    bytes.clear();
+    writes = 0;
+    return s;
+  }
+};
+
+
+int main()
+{
+  SerialRecorder serial;
+  LiquidCrystal_PCF8574 lcd(serial);
+  byte bar[8] = { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F };
+
+  lcd.begin(16, 2);
+  // display control, clear and entry mode, the backpack owns the function set
+  CHECK_EQUAL(serial.take(), "FE 0C FE 01 FE 06");
+
+  lcd.print("Hello");
+  CHECK_EQUAL(serial.writes, 1);
+  CHECK_EQUAL(serial.take(), "'Hello'");
+
+  lcd.write('!');
+  CHECK_EQUAL(serial.take(), "'!'");
+
+  lcd.setCursor(3, 1);
+  CHECK_EQUAL(serial.take(), "FE C3");
+  lcd.setCursor(0, 0);
+  CHECK_EQUAL(serial.take(), "FE 80");
+
+  lcd.clear();
+  CHECK_EQUAL(serial.take(), "FE 01");
+  lcd.home();
+  CHECK_EQUAL(serial.take(), "FE 02");
+
+  lcd.cursor();
+  CHECK_EQUAL(serial.take(), "FE 0E");
+  lcd.blink();
+  CHECK_EQUAL(serial.take(), "FE 0F");
+  lcd.noCursor();
+  CHECK_EQUAL(serial.take(), "FE 0D");
+  lcd.noBlink();
+  CHECK_EQUAL(serial.take(), "FE 0C");
+  lcd.noDisplay();
+  CHECK_EQUAL(serial.take(), "FE 08");
+  lcd.display();
+  CHECK_EQUAL(serial.take(), "FE 0C");
+
+  lcd.scrollDisplayLeft();
+  CHECK_EQUAL(serial.take(), "FE 18");
+  lcd.scrollDisplayRight();
+  CHECK_EQUAL(serial.take(), "FE 1C");
+  lcd.moveCursorLeft();
+  CHECK_EQUAL(serial.take(), "FE 10");
+  lcd.moveCursorRight();
+  CHECK_EQUAL(serial.take(), "FE 14");
+
+  lcd.rightToLeft();
+  CHECK_EQUAL(serial.take(), "FE 04");
+  lcd.autoscroll();
+  CHECK_EQUAL(serial.take(), "FE 05");
+  lcd.noAutoscroll();
+  CHECK_EQUAL(serial.take(), "FE 04");
+  lcd.leftToRight();
+  CHECK_EQUAL(serial.take(), "FE 06");
+
+  // the backlight brightness 0..255 is mapped to the settings 128..157
+  lcd.setBacklight(255);
+  CHECK_EQUAL(serial.take(), "7C 9D");
+  lcd.setBacklight(0);
+  CHECK_EQUAL(serial.take(), "7C 80");
+  lcd.setBacklight(128);
+  CHECK_EQUAL(serial.take(), "7C 8E");
+
+  // custom characters are defined and shown by settings
+  lcd.createChar(1, bar);
+  CHECK_EQUAL(serial.take(), "7C 1C 1F 1F 1F 1F 1F 1F 1F 1F");
+  lcd.setCursor(0, 1);
+  serial.take();
+  lcd.write(1);
+  CHECK_EQUAL(serial.take(), "7C 24");
+  lcd.write((const uint8_t *)"a\001b\007", 4);
+  CHECK_EQUAL(serial.take(), "'a' 7C 24 'b' 7C 2A");
+
+  // characters that start commands cannot be shown
+  lcd.print("a|b");
+  CHECK_EQUAL(serial.take(), "'a b'");
+  lcd.write(0xFE);
+  CHECK_EQUAL(serial.take(), "' '");
+
+  // writeAt() sets the cursor only when the position is not known
+  lcd.writeAt(0, 0, (const uint8_t *)"ab", 2);
+  CHECK_EQUAL(serial.take(), "FE 80 'ab'");
+  lcd.writeAt(2, 0, (const uint8_t *)"cd", 2);
+  CHECK_EQUAL(serial.take(), "'cd'");
+
+  // a raw instruction, except the function set
+  lcd.command(0x80 | 0x45);
+  CHECK_EQUAL(serial.take(), "FE C5");
+  lcd.command(0x28);
+  CHECK_EQUAL(serial.take(), "");
+
+  // the backpack does the display timing, there are no buttons or spare pins
+  CHECK_EQUAL(lcd.waitBusy(), 0);
+  CHECK_EQUAL(lcd.sparePins(), 0);
+  lcd.setSparePin(3, true);
+  CHECK_EQUAL(lcd.pollButtons(), 0);
+  CHECK_EQUAL(serial.take(), "");
+  CHECK_EQUAL(simBus.transmissions, 0);
+  CHECK_EQUAL(lcd.lastError(), 0);
+
+  return test_result("test_serlcd");
+}
@@ -0,0 +1,464 @@
+// Soak test: random operations on the display functions, compared with a model of the display after every step.
+//
+// The model follows the datasheet for what the functions must have done: display RAM, character generator RAM,
+// address counter, display shift, entry mode and display control. The simulation also checks the bus timing:
+// no RS or RW change together with a rising E and no instruction while the display is busy.
+// The operations include page switches, re-initialization by begin() and beginWarm() and injected faults.
+// After a fault the test does what an application does when lastError() reports it: begin(), set the backlight
+// and upload the custom characters again.
+//
+// The steps are counted in windows. For every window the simulated time, the transmissions and bytes per step
+// are measured without the faults and their recovery; a window that differs from the first one by more than
+// a quarter shows a drift.
+//
+// The sequence of operations is the same in every run, a failure is reported with the step and the seed.
+// usage: test_soak [steps per display size], the default is a short run for every make,
+// "make soak" runs a long one.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+#include <stdlib.h>
+
+#define SEED 20261018UL
+#define STEPS 200000UL ///< default steps per display size
+#define WINDOW 20000UL ///< steps of a window for the drift
+#define FAULT_RATE 500 ///< a fault in about every FAULT_RATE steps
+
+static unsigned long rnd_state;
+
+// a small LCG so the sequence does not depend on the C library
+static unsigned int rnd(unsigned int n)
+{
+  rnd_state = rnd_state * 1103515245UL + 12345UL;
+  return ((rnd_state >> 16) & 0x7FFF) % n;
+}
+
+
+/// What the display must contain after the operations.
+struct Model {
+  uint8_t cols, rows;
+  uint8_t ddram[128];
+  uint8_t cgram[64];
+  uint8_t ac;
+  uint8_t shift;
+  uint8_t entryMode;
+  uint8_t displayControl;
+  bool backlight;
+  unsigned long violations; ///< violations and busy writes of the simulation that were caused by faults
+  unsigned long busyWrites;
+
+  uint8_t lineLen() { return (rows > 1) ? 40 : 80; }
+  uint8_t pageOffset() { return (rows > 1) ? 20 : 40; }
+
+  // the state after begin()
+  void begin(uint8_t c, uint8_t r)
+  {
+    cols = c;
+    rows = r;
+    memset(ddram, ' ', sizeof(ddram));
+    ac = 0;
+    shift = 0;
+    entryMode = 0x02;
+    displayControl = 0x04;
+  }
+
+  void step(bool increment)
+  {
+    if (rows > 1) {
+      if (increment)
+        ac = (ac == 0x27) ? 0x40 : (ac == 0x67) ? 0x00 : ac + 1;
+      else
+        ac = (ac == 0x40) ? 0x27 : (ac == 0x00) ? 0x67 : ac - 1;
+    } else {
+      ac = increment ? (ac + 1) % 80 : (ac + 79) % 80;
+    }
+  }
+
+  void shiftDisplay(bool left) { shift = left ? (shift + 1) % lineLen() : (shift + lineLen() - 1) % lineLen(); }
+
+  void write(uint8_t c)
+  {
+    ddram[ac] = c;
+    step(entryMode & 0x02);
+    if (entryMode & 0x01)
+      shiftDisplay(entryMode & 0x02);
+  }
+
+  // the display RAM address of a position when the display is shifted by offset
+  uint8_t address(uint8_t offset, uint8_t col, uint8_t row)
+  {
+    static const uint8_t base[4] = { 0x00, 0x40, 0x14, 0x54 };
+    if (rows <= 1)
+      return (col + offset) % 80;
+    return (base[row] & 0x40) | (((base[row] & 0x3F) + col + offset) % 40);
+  }
+
+  void setCursor(uint8_t col, uint8_t row)
+  {
+    static const uint8_t base[4] = { 0x00, 0x40, 0x14, 0x54 };
+    ac = base[row] + col;
+  }
+
+  // the text appears at the position, the address counter is behind the last character written
+  void writeAt(uint8_t offset, uint8_t col, uint8_t row, const uint8_t *text, uint8_t len)
+  {
+    for (uint8_t i = 0; i < len; i++)
+      ddram[address(offset, col + i, row)] = text[i];
+    if (entryMode & 0x02) {
+      ac = address(offset, col + len - 1, row);
+      step(true);
+    } else {
+      ac = address(offset, col, row);
+      step(false);
+    }
+  }
+
+  void home()
+  {
+    ac = 0;
+    shift = 0;
+  }
+};
+
+
+/// Sums of a window of steps without the faults.
+struct Window {
+  unsigned long steps;
+  unsigned long time; ///< simulated microseconds
+  unsigned long transmissions;
+  unsigned long bytes;
+};
+
+
+static bool compare(LcdSim &sim, Model &m, unsigned long n, bool full)
+{
+  bool ok = true;
+  ok &= CHECK_EQUAL(sim.ac(), m.ac);
+  ok &= CHECK_EQUAL(sim.shift(), m.shift);
+  ok &= CHECK_EQUAL(sim.entryMode(), m.entryMode);
+  ok &= CHECK_EQUAL(sim.displayControl(), m.displayControl);
+  ok &= CHECK_EQUAL(sim.backlight(), m.backlight);
+  ok &= CHECK_EQUAL(sim.violations, m.violations);
+  ok &= CHECK_EQUAL(sim.busyWrites, m.busyWrites);
+  if (full) {
+    for (uint8_t a = 0; a < 128; a++) {
+      if ((m.rows > 1) ? ((a & 0x3F) >= 40) : (a >= 80))
+        continue;
+      ok &= CHECK_EQUAL(sim.ddram(a), m.ddram[a]);
+    }
+    for (uint8_t a = 0; a < 64; a++)
+      ok &= CHECK_EQUAL(sim.cgram(a), m.cgram[a]);
+  }
+  if (!ok)
+    printf("after step %lu of the sequence with seed %lu\n", n, SEED);
+  return ok;
+}
+
+
+// compare a window with the first one
+static bool drift(const Window &w, const Window &first, unsigned long n)
+{
+  bool ok = true;
+  double scale = (double)first.steps / w.steps;
+  double time = w.time * scale, transmissions = w.transmissions * scale, bytes = w.bytes * scale;
+
+  ok &= CHECK((time > first.time * 0.75) && (time < first.time * 1.25));
+  ok &= CHECK((transmissions > first.transmissions * 0.75) && (transmissions < first.transmissions * 1.25));
+  ok &= CHECK((bytes > first.bytes * 0.75) && (bytes < first.bytes * 1.25));
+  if (!ok)
+    printf("drift in the window before step %lu: %.1f usec, %.2f transmissions, %.2f bytes per step\n",
+      n, (double)w.time / w.steps, (double)w.transmissions / w.steps, (double)w.bytes / w.steps);
+  return ok;
+}
+
+
+// what an application does after lastError(): initialize the display and restore the backlight and custom characters
+static void recover(LiquidCrystal_PCF8574 &lcd, Model &m)
+{
+  lcd.begin(m.cols, m.rows);
+  lcd.setBacklight(m.backlight ? 255 : 0);
+  for (uint8_t location = 0; location < 8; location++)
+    lcd.preloadChar(location, m.cgram + location * 8);
+  m.begin(m.cols, m.rows);
+}
+
+
+static void soak(LiquidCrystal_PCF8574 &lcd, LcdSim &sim, uint8_t cols, uint8_t rows, unsigned long steps)
+{
+  static const uint8_t faults[] = { LCD_FAULT_NACK_ADDRESS, LCD_FAULT_NACK_DATA, LCD_FAULT_TIMEOUT, LCD_FAULT_SHORT_READ };
+  Model m;
+  Window w, first;
+  uint8_t text[41];
+  uint8_t glyph[8];
+  unsigned long injected = 0, detected = 0, reinits = 0, windows = 0;
+  unsigned long faultTime = 0, waitTime = 0;
+  unsigned long start = micros();
+
+  rnd_state = SEED;
+  lcd.begin(cols, rows);
+  m.begin(cols, rows);
+  m.backlight = false;
+  m.violations = sim.violations;
+  m.busyWrites = sim.busyWrites;
+  for (uint8_t a = 0; a < 64; a++)
+    m.cgram[a] = sim.cgram(a);
+  memset(&w, 0, sizeof(w));
+  memset(&first, 0, sizeof(first));
+
+  for (unsigned long n = 0; n < steps; n++) {
+    uint8_t col = rnd(cols);
+    uint8_t row = rnd(rows);
+    uint8_t len = 1 + rnd(cols - col);
+    for (uint8_t i = 0; i < len; i++)
+      text[i] = 'A' + rnd(58);
+
+    // a fault in one of the next transmissions of this step
+    unsigned long faultCount = sim.faults;
+    if (rnd(FAULT_RATE) == 0) {
+      sim.failTransmissions(faults[rnd(sizeof(faults))], 1 + rnd(3));
+      injected++;
+    }
+
+    LcdSimBus bus = simBus;
+    unsigned long t = micros();
+    bool wait = false;
+    bool warmFailed = false;
+
+    switch (rnd(28)) {
+      case 0:
+        m.backlight = rnd(2);
+        lcd.setBacklight(m.backlight ? 255 : 0);
+        break;
+      case 1:
+      case 2:
+        text[len] = '\0';
+        lcd.print((const char *)text);
+        for (uint8_t i = 0; i < len; i++)
+          m.write(text[i]);
+        break;
+      case 3:
+        lcd.write(text[0]);
+        m.write(text[0]);
+        break;
+      case 4:
+      case 5:
+        lcd.setCursor(col, row);
+        m.setCursor(col, row);
+        break;
+      case 6:
+        // rare, it takes 1.5 msec
+        if (rnd(20) == 0) {
+          lcd.clear();
+          memset(m.ddram, ' ', sizeof(m.ddram));
+          m.home();
+          m.entryMode |= 0x02;
+          wait = true;
+        }
+        break;
+      case 7:
+        if (rnd(10) == 0) {
+          lcd.home();
+          m.home();
+          wait = true;
+        }
+        break;
+      case 8:
+        if (rnd(2)) {
+          lcd.cursor();
+          m.displayControl |= 0x02;
+        } else {
+          lcd.noCursor();
+          m.displayControl &= ~0x02;
+        }
+        break;
+      case 9:
+        if (rnd(2)) {
+          lcd.blink();
+          m.displayControl |= 0x01;
+        } else {
+          lcd.noBlink();
+          m.displayControl &= ~0x01;
+        }
+        break;
+      case 10:
+        if (rnd(4)) {
+          lcd.display();
+          m.displayControl |= 0x04;
+        } else {
+          lcd.noDisplay();
+          m.displayControl &= ~0x04;
+        }
+        break;
+      case 11:
+        lcd.scrollDisplayLeft();
+        m.shiftDisplay(true);
+        break;
+      case 12:
+        lcd.scrollDisplayRight();
+        m.shiftDisplay(false);
+        break;
+      case 13:
+        lcd.moveCursorLeft();
+        m.step(false);
+        break;
+      case 14:
+        lcd.moveCursorRight();
+        m.step(true);
+        break;
+      case 15:
+        if (rnd(3)) {
+          lcd.leftToRight();
+          m.entryMode |= 0x02;
+        } else {
+          lcd.rightToLeft();
+          m.entryMode &= ~0x02;
+        }
+        break;
+      case 16:
+        if (rnd(3)) {
+          lcd.noAutoscroll();
+          m.entryMode &= ~0x01;
+        } else {
+          lcd.autoscroll();
+          m.entryMode |= 0x01;
+        }
+        break;
+      case 17:
+      case 18:
+      case 19:
+        // a field update
+        lcd.writeAt(col, row, text, len);
+        m.writeAt(m.shift, col, row, text, len);
+        break;
+      case 20: {
+        // in every entry mode, the bitmap is written in increment mode
+        uint8_t location = rnd(8);
+        for (uint8_t i = 0; i < 8; i++)
+          glyph[i] = rnd(32);
+        lcd.preloadChar(location, glyph);
+        memcpy(m.cgram + location * 8, glyph, 8);
+        break;
+      }
+      case 21:
+        // a custom character
+        text[0] = rnd(8);
+        lcd.write(text[0]);
+        m.write(text[0]);
+        break;
+      case 22:
+        lcd.waitBusy();
+        wait = true;
+        break;
+      case 23:
+      case 24: {
+        // a screen switch: write a page and show it
+        uint8_t page = rnd(lcd.pageCount());
+        lcd.writePage(page, col, row, text, len);
+        m.writeAt(page * m.pageOffset(), col, row, text, len);
+        if (rnd(2) == 0)
+          break;
+        lcd.showPage(page);
+        if ((page == 0) && (m.shift != 0)) {
+          m.home();
+          wait = true;
+        } else if (page == 1) {
+          m.shift = m.pageOffset();
+        }
+        break;
+      }
+      case 25:
+        // rare re-initialization, the content of the display RAM is lost or kept
+        if (rnd(50) == 0) {
+          reinits++;
+          if (rnd(2)) {
+            lcd.begin(cols, rows);
+            m.begin(cols, rows);
+          } else if (lcd.beginWarm(cols, rows)) {
+            m.entryMode = 0x02;
+            m.displayControl = 0x04;
+            m.home();
+          } else {
+            // a fault while probing the display: the complete begin() was done
+            m.begin(cols, rows);
+            warmFailed = true;
+          }
+          wait = true;
+        }
+        break;
+      default:
+        lcd.print((long)n);
+        len = snprintf((char *)text, sizeof(text), "%lu", n);
+        for (uint8_t i = 0; i < len; i++)
+          m.write(text[i]);
+        break;
+    }
+    sim.clearFaults();
+
+    // a fault that happened is reported by lastError(), the display is initialized again.
+    // Only beginWarm() handles a fault by itself with the complete begin().
+    bool happened = (sim.faults != faultCount);
+    bool reported = (lcd.lastError() != 0);
+    if (!CHECK_EQUAL(reported || warmFailed, happened)) {
+      printf("fault not reported after step %lu of the sequence with seed %lu\n", n, SEED);
+      return;
+    }
+    if (happened) {
+      detected++;
+      m.violations = sim.violations;
+      m.busyWrites = sim.busyWrites;
+      if (reported)
+        recover(lcd, m);
+      faultTime += micros() - t;
+      if (!compare(sim, m, n, true))
+        return;
+      continue;
+    }
+
+    if (wait)
+      waitTime += micros() - t;
+    w.steps++;
+    w.time += micros() - t;
+    w.transmissions += simBus.transmissions - bus.transmissions;
+    w.bytes += simBus.bytes - bus.bytes;
+
+    if (!compare(sim, m, n, (n % 64) == 0))
+      return;
+
+    if ((n + 1) % WINDOW == 0) {
+      if (windows++ == 0)
+        first = w;
+      else if (!drift(w, first, n + 1))
+        return;
+      memset(&w, 0, sizeof(w));
+    }
+  }
+  compare(sim, m, steps, true);
+  CHECK_EQUAL(lcd.lastError(), 0);
+  CHECK_EQUAL(simBus.overflows, 0);
+
+  printf("%dx%d: %lu steps, %lu usec simulated, %lu usec waiting for the display, %lu re-inits,"
+    " %lu faults injected, %lu happened, %lu usec blocked by faults and recovery\n",
+    cols, rows, steps, micros() - start, waitTime, reinits, injected, detected, faultTime);
+} // soak()
+
+
+int main(int argc, char *argv[])
+{
+  unsigned long steps = (argc > 1) ? strtoul(argv[1], NULL, 10) : STEPS;
+
+  LcdSim sim20x4(0x27);
+  LiquidCrystal_PCF8574 lcd20x4(0x27);
+  soak(lcd20x4, sim20x4, 20, 4, steps);
+
+  // another pin mapping, the busy flag is on bit 3
+  LcdSim sim16x2(0x26, 4, 5, 6, 0, 1, 2, 3, 7);
+  LiquidCrystal_PCF8574 lcd16x2(0x26, 4, 5, 6, 0, 1, 2, 3, 7);
+  soak(lcd16x2, sim16x2, 16, 2, steps);
+
+  LcdSim sim40x1(0x25);
+  LiquidCrystal_PCF8574 lcd40x1(0x25);
+  soak(lcd40x1, sim40x1, 40, 1, steps);
+
+  return test_result("test_soak");
+}
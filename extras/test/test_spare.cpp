@@ -0,0 +1,104 @@
+// Test of the spare pins: pins of the PCF8574 that are not connected to the display, used as outputs or for buttons.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+
+int main()
+{
+  // an adapter without RW and backlight: pins 1 and 3 are spare
+  LcdSim sim(0x27, 0, 255, 2, 4, 5, 6, 7, 255);
+  LiquidCrystal_PCF8574 lcd(0x27, 0, 2, 4, 5, 6, 7);
+
+  // a spare pin can be set before begin(), RS goes LOW with it
+  lcd.setSparePin(3, true);
+  CHECK_EQUAL(sim.port() & 0x0B, 0x08);
+  lcd.setSparePin(3, false);
+
+  lcd.begin(16, 2);
+  CHECK_EQUAL(lcd.sparePins(), 0x0A);
+  CHECK_EQUAL(sim.port() & 0x0A, 0);
+
+  lcd.setSparePin(3, true);
+  CHECK_EQUAL(sim.port() & 0x0A, 0x08);
+  lcd.setSparePin(3, false);
+  CHECK_EQUAL(sim.port() & 0x0A, 0);
+
+  // pins that are connected to the display are not changed
+  lcd.setSparePin(2, true);
+  CHECK_EQUAL(sim.port() & 0x04, 0);
+
+  // there is no pin 8 or higher, nothing is sent
+  unsigned long transmissions = sim.transmissions;
+  for (uint8_t pin = 8; pin < 255; pin++)
+    lcd.setSparePin(pin, true);
+  CHECK_EQUAL(sim.transmissions, transmissions);
+  CHECK_EQUAL(sim.port() & 0x0A, 0);
+
+  // a button pin is HIGH so the PCF8574 reads it, it is not an output
+  lcd.setButtonPins(0x02);
+  CHECK_EQUAL(sim.port() & 0x0A, 0x02);
+  lcd.setSparePin(1, false);
+  CHECK_EQUAL(sim.port() & 0x0A, 0x02);
+  sim.buttons = 0x02;
+  for (uint8_t n = 0; n < 20; n++) {
+    delay(5);
+    lcd.pollButtons();
+  }
+  CHECK_EQUAL(lcd.buttons(), 0x02);
+  CHECK_EQUAL(lcd.buttonPresses(), 0x02);
+  sim.buttons = 0;
+
+  // a pin that is no longer a button is LOW again and can be used as output
+  lcd.setButtonPins(0x08);
+  CHECK_EQUAL(sim.port() & 0x0A, 0x08);
+  lcd.setSparePin(1, true);
+  CHECK_EQUAL(sim.port() & 0x0A, 0x0A);
+  lcd.setButtonPins(0);
+  CHECK_EQUAL(sim.port() & 0x0A, 0x02);
+  CHECK_EQUAL(lcd.buttons(), 0);
+
+  CHECK_EQUAL(sim.violations, 0);
+
+  // an adapter with RW and without backlight: pin 3 is spare. The reads of the busy flag
+  // in clear() and home() sample the buttons, pollButtons() is not needed.
+  LcdSim simRW(0x26, 0, 1, 2, 4, 5, 6, 7, 255);
+  LiquidCrystal_PCF8574 lcdRW(0x26, 0, 1, 2, 4, 5, 6, 7, 255);
+  lcdRW.begin(16, 2);
+  CHECK_EQUAL(lcdRW.sparePins(), 0x08);
+  lcdRW.setButtonPins(0x08);
+  lcdRW.print("buttons");
+
+  // without transfers the buttons are not read
+  simRW.buttons = 0x08;
+  delay(50);
+  CHECK_EQUAL(lcdRW.buttons(), 0);
+
+  unsigned long start = millis();
+  transmissions = simRW.transmissions;
+  uint8_t n = 0;
+  while ((lcdRW.buttonPresses() == 0) && (n++ < 50)) {
+    lcdRW.clear();
+    lcdRW.print("pressed");
+  }
+  CHECK_EQUAL(lcdRW.buttons(), 0x08);
+  CHECK(millis() - start >= 20);
+  CHECK(millis() - start < 40);
+  printf("button press found by %d clear() in %lu msec, %lu transmissions\n", n, millis() - start,
+    simRW.transmissions - transmissions);
+
+  simRW.buttons = 0;
+  start = millis();
+  n = 0;
+  while ((lcdRW.buttonReleases() == 0) && (n++ < 50))
+    lcdRW.home();
+  CHECK_EQUAL(lcdRW.buttons(), 0);
+  CHECK(millis() - start >= 20);
+  CHECK(millis() - start < 40);
+
+  CHECK_EQUAL(simRW.row(0, 16), "pressed         ");
+  CHECK_EQUAL(simRW.busyWrites, 0);
+  CHECK_EQUAL(simRW.violations, 0);
+  CHECK_EQUAL(lcdRW.lastError(), 0);
+  return test_result("test_spare");
+}
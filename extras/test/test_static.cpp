@@ -0,0 +1,126 @@
+// Test of the classes with static storage: every template of LiquidCrystal_PCF8574_Static.h is instantiated
+// and used on a simulated display.
+//
+// Built with -DSTATIC_FAIL=n the test instantiates a template with an unsupported size instead,
+// the Makefile checks that these builds fail.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574_Static.h>
+
+int temp = 215;
+long count = 0;
+char name[4] = "abc";
+
+const char layout[] PROGMEM = "Temp:      C\nCount:";
+const LiquidCrystal_PCF8574_Field fields[3] PROGMEM = {
+  { 6, 0, 5, LCD_FIELD_INT, 1, &temp, 0 },
+  { 7, 1, 8, LCD_FIELD_LONG, 0, &count, 0 },
+  { 13, 0, 3, LCD_FIELD_STRING, 0, name, 0 }
+};
+
+const char item0[] PROGMEM = "Settings";
+const char item1[] PROGMEM = "Information";
+const char item2[] PROGMEM = "Exit";
+const char *const items[] PROGMEM = { item0, item1, item2 };
+
+const uint8_t frames[] PROGMEM = { 'L', 'F', 16, 2, 1, 0, 100, 0, 0x02, 0, 2, 'H', 'i', 0x00 };
+
+const uint8_t glyphs[10][8] PROGMEM = {
+  { 0x01 }, { 0x02 }, { 0x03 }, { 0x04 }, { 0x05 }, { 0x06 }, { 0x07 }, { 0x08 }, { 0x09 }, { 0x0A }
+};
+
+#if STATIC_FAIL == 1
+LiquidCrystal_PCF8574_StaticMenu<41, 1> *fail; // more than 40 columns
+#elif STATIC_FAIL == 2
+LiquidCrystal_PCF8574_StaticMenu<40, 4> *fail; // more than 80 characters
+#elif STATIC_FAIL == 3
+LiquidCrystal_PCF8574_StaticPlayer<8, 16> *fail; // no room for a CGRAM record
+#elif STATIC_FAIL == 4
+LiquidCrystal_PCF8574_StaticPlayer<16, 16> *fail; // no room for a row record
+#elif STATIC_FAIL == 5
+LiquidCrystal_PCF8574_StaticScreen<3, 2> *fail; // fewer characters than fields
+#elif STATIC_FAIL == 6
+LiquidCrystal_PCF8574_StaticGlyphs<255> *fail; // glyph indexes collide with LCD_GLYPH_NONE
+#elif STATIC_FAIL == 7
+LiquidCrystal_PCF8574_StaticExchange<16, 0> *fail; // no rows
+#endif
+
+#if STATIC_FAIL
+// instantiate the class of the pointer
+void failing(LiquidCrystal_PCF8574 &lcd) { (void)sizeof(*fail); (void)lcd; }
+#endif
+
+
+int main()
+{
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  lcd.begin(16, 2);
+
+  // the storage is part of the object
+  static_assert(sizeof(LiquidCrystal_PCF8574_StaticScreen<3, 16>) >= sizeof(LiquidCrystal_PCF8574_Screen) + 16, "screen cache");
+  static_assert(sizeof(LiquidCrystal_PCF8574_StaticScreen<3, 16, true>)
+    >= sizeof(LiquidCrystal_PCF8574_Screen) + 16 + 3 * sizeof(LiquidCrystal_PCF8574_Latency), "screen statistics");
+  static_assert(sizeof(LiquidCrystal_PCF8574_StaticPlayer<32, 16>) >= sizeof(LiquidCrystal_PCF8574_Player) + 32, "player buffer");
+  static_assert(sizeof(LiquidCrystal_PCF8574_StaticExchange<16, 2>)
+    >= sizeof(LiquidCrystal_PCF8574_Exchange) + LCD_EXCHANGE_SIZE(16, 2), "exchange frames");
+
+  // a screen with latency statistics
+  LiquidCrystal_PCF8574_StaticScreen<3, 16, true> screen(lcd, layout, fields);
+  CHECK_EQUAL(screen.fieldCount(), 3);
+  screen.draw();
+  CHECK_EQUAL(sim.row(0, 16), "Temp:  21.5C abc");
+  CHECK_EQUAL(sim.row(1, 16), "Count:        0 ");
+  count = 42;
+  screen.changed(1);
+  delay(3);
+  screen.refresh();
+  CHECK_EQUAL(sim.row(1, 16), "Count:       42 ");
+  CHECK(screen.latencyMax(1) >= 3000);
+  CHECK_EQUAL(screen.latencyMax(0), 0);
+
+  // without statistics, a cache that is too small for the last field
+  LiquidCrystal_PCF8574_StaticScreen<3, 13> small(lcd, layout, fields);
+  CHECK_EQUAL(small.fieldCount(), 2);
+  small.changed(0);
+  small.refresh();
+  CHECK_EQUAL(small.latencyMax(0), 0);
+
+  // a menu
+  LiquidCrystal_PCF8574_StaticMenu<16, 2> menu(lcd, items, 3);
+  lcd.clear();
+  menu.draw();
+  menu.next();
+  menu.next();
+  CHECK_EQUAL(menu.top(), 1);
+  CHECK_EQUAL(sim.row(0, 16), " Information    ");
+  CHECK_EQUAL(sim.row(1, 16), ">Exit           ");
+
+  // a player with its buffer
+  LiquidCrystal_PCF8574_StaticPlayer<32, 16> player(lcd);
+  lcd.clear();
+  CHECK(player.begin(frames, sizeof(frames)));
+  CHECK(player.update());
+  CHECK_EQUAL(sim.row(0, 16), "Hi              ");
+
+  // glyphs from a table of 10
+  LiquidCrystal_PCF8574_StaticGlyphs<10> cgram(lcd, glyphs);
+  const uint8_t current[] = { 0, 9 };
+  CHECK(cgram.use(current, 2));
+  CHECK(cgram.slot(9) != LCD_GLYPH_NONE);
+  CHECK_EQUAL(sim.cgram(cgram.slot(9) * 8), 0x0A);
+
+  // a frame exchange
+  LiquidCrystal_PCF8574_StaticExchange<16, 2> exchange(lcd);
+  memset(exchange.frame(), ' ', 16 * 2);
+  memcpy(exchange.frame() + 16, "exchange", 8);
+  exchange.publish();
+  CHECK(exchange.flush());
+  CHECK_EQUAL(sim.row(1, 16), "exchange        ");
+  CHECK(!exchange.flush());
+
+  CHECK_EQUAL(sim.violations, 0);
+  CHECK_EQUAL(lcd.lastError(), 0);
+  return test_result("test_static");
+}
@@ -0,0 +1,118 @@
+// Test of the compressed texts: a table packed by extras/text/lcd_text.py (test_text.txt) is decoded by
+// LiquidCrystal_PCF8574_Text and compared with the strings, character by character and on the display.
+//
+// The table has strings with literals that collide with the tokens, runs, dictionary entries and three strings
+// of 255 characters, the most that the length byte of the blob and the uint8_t counter of the decoder hold.
+
+#include "lcd_sim.h"
+#include "test.h"
+#include <LiquidCrystal_PCF8574.h>
+#include <LiquidCrystal_PCF8574_Text.h>
+
+#include "text_table.h" // generated from test_text.txt
+
+#define MAX_LENGTH 255
+
+
+// the strings of test_text.txt
+static std::string expected(uint16_t index)
+{
+  static const char control[] = { 0, 1, 7, ' ', 0, 1, (char)0x80, (char)0xFF, '\\', '!' };
+  std::string s;
+
+  switch (index) {
+    case MENU_MAIN:
+      return "Main menu\n> Settings\n  Info\n  About";
+    case MENU_SETTINGS:
+      return "Settings\n> Backlight\n  Contrast\n  Back";
+    case CONTROL:
+      return std::string(control, sizeof(control));
+    case RUN_MAX:
+      return std::string(MAX_LENGTH, '-');
+    case DIGITS_MAX:
+      for (int i = 0; i < MAX_LENGTH; i++)
+        s += (char)('0' + i % 10);
+      return s;
+    case MIXED_MAX:
+      for (int i = 0; i < 12; i++)
+        s += "012345678901234.....x";
+      return s + "end";
+  }
+  return s;
+}
+
+
+// read() and peek() return the characters of the string and available() counts down
+static void readAll(LiquidCrystal_PCF8574_Text &text, uint16_t index)
+{
+  std::string s = expected(index);
+
+  CHECK(text.open(index));
+  CHECK_EQUAL(text.available(), (int)s.size());
+  for (size_t i = 0; i < s.size(); i++) {
+    int c = (uint8_t)s[i];
+    if (!CHECK_EQUAL(text.peek(), c) || !CHECK_EQUAL(text.read(), c)) {
+      printf("string %u, character %u\n", index, (unsigned)i);
+      return;
+    }
+    CHECK_EQUAL(text.available(), (int)(s.size() - i - 1));
+  }
+  CHECK_EQUAL(text.peek(), -1);
+  CHECK_EQUAL(text.read(), -1);
+  CHECK_EQUAL(text.available(), 0);
+}
+
+
+int main()
+{
+  LiquidCrystal_PCF8574_Text text(text_table);
+
+  CHECK_EQUAL(text.count(), 7);
+  for (uint16_t index = 0; index < text.count(); index++)
+    readAll(text, index);
+
+  // the longest strings fill the counter
+  CHECK(text.open(RUN_MAX));
+  CHECK_EQUAL(text.available(), MAX_LENGTH);
+  CHECK(text.open(MIXED_MAX));
+  CHECK_EQUAL(text.available(), MAX_LENGTH);
+
+  // open() starts again in the middle of a run and of a dictionary entry
+  CHECK(text.open(RUN_MAX));
+  text.read();
+  readAll(text, MENU_MAIN);
+  CHECK(text.open(DIGITS_MAX));
+  text.read();
+  text.read();
+  readAll(text, MIXED_MAX);
+
+  // a string that does not exist
+  CHECK(!text.open(7));
+  CHECK_EQUAL(text.available(), 0);
+  CHECK_EQUAL(text.read(), -1);
+
+  // show() starts a row for every '\n'
+  LcdSim sim(0x27);
+  LiquidCrystal_PCF8574 lcd(0x27);
+  lcd.begin(20, 4);
+  CHECK_EQUAL(text.show(lcd, MENU_MAIN), expected(MENU_MAIN).size());
+  CHECK_EQUAL(sim.row(0, 20), "Main menu           ");
+  CHECK_EQUAL(sim.row(1, 20), "> Settings          ");
+  CHECK_EQUAL(sim.row(2, 20), "  Info              ");
+  CHECK_EQUAL(sim.row(3, 20), "  About             ");
+  CHECK_EQUAL(text.show(lcd, EMPTY), 0);
+
+  // show() sends all 255 characters of a string
+  for (uint16_t index = RUN_MAX; index <= MIXED_MAX; index++) {
+    lcd.home();
+    unsigned long c = sim.characters;
+    CHECK_EQUAL(text.show(lcd, index), MAX_LENGTH);
+    CHECK_EQUAL(sim.characters - c, MAX_LENGTH);
+    CHECK_EQUAL(text.available(), 0);
+  }
+  CHECK_EQUAL(text.show(lcd, 7), 0);
+
+  CHECK_EQUAL(sim.violations, 0);
+  CHECK_EQUAL(lcd.lastError(), 0);
+  return test_result("test_text");
+}
@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""Pack strings and screens into a compressed PROGMEM blob for LiquidCrystal_PCF8574_Text.
+
+Input format (text), one string per line:
+
+    # comment
+    MENU_MAIN = Main menu\\n> Settings\\n  Info
+    HELP_1    = Press OK to start
+
+Escapes: \\n (next row), \\\\, \\0 .. \\7 (CGRAM characters), \\xHH.
+Every string decodes to at most 255 characters.
+
+The output is a C header with a #define for the index of every string and the blob:
+
+    lcd_text.py strings.txt -n ui_text -o ui_text.h
+
+Use it in the sketch:
+
+    LiquidCrystal_PCF8574_Text text(ui_text);
+    text.show(lcd, MENU_MAIN);
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+TOKEN_LITERAL = 0x00
+TOKEN_RUN = 0x01
+TOKEN_DICT = 0x80
+
+MAX_DICT = 128
+MIN_RUN = 4
+
+
+def unescape(text):
+    def repl(m):
+        s = m.group(1)
+        if s == 'n':
+            return '\n'
+        if s == '\\':
+            return '\\'
+        if s[0] == 'x':
+            return chr(int(s[1:], 16))
+        return chr(int(s))
+    return re.sub(r'\\(n|\\|x[0-9a-fA-F]{2}|[0-7])', repl, text).encode('latin-1')
+
+
+def parse(text):
+    entries = []
+    for line in text.splitlines():
+        if not line.strip() or line.lstrip().startswith('#'):
+            continue
+        name, sep, value = line.partition('=')
+        name = name.strip()
+        if not sep or not re.match(r'^[A-Za-z_][A-Za-z0-9_]*$', name):
+            raise ValueError('expected NAME = text: ' + line)
+        data = unescape(value.strip())
+        if len(data) > 255:
+            raise ValueError('string too long: ' + name)
+        entries.append((name, data))
+    return entries
+
+
+def literal(c):
+    if c in (TOKEN_LITERAL, TOKEN_RUN) or c >= TOKEN_DICT:
+        return bytes([TOKEN_LITERAL, c])
+    return bytes([c])
+
+
+def encode_string(data, dictionary):
+    """Greedy encoding with runs and the longest matching dictionary entry."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < 255:
+            run += 1
+        if run >= MIN_RUN:
+            out += bytes([TOKEN_RUN, run, data[i]])
+            i += run
+            continue
+        best = -1
+        for n, word in enumerate(dictionary):
+            if len(word) > 1 and data.startswith(word, i) and (best < 0 or len(word) > len(dictionary[best])):
+                best = n
+        if best >= 0:
+            out.append(TOKEN_DICT + best)
+            i += len(dictionary[best])
+        else:
+            out += literal(data[i])
+            i += 1
+    return bytes(out)
+
+
+def build_dictionary(strings):
+    """Pick the substrings that save the most bytes, one at a time."""
+    dictionary = []
+    while len(dictionary) < MAX_DICT:
+        current = sum(len(encode_string(s, dictionary)) for s in strings)
+        candidates = {}
+        for s in strings:
+            for length in range(3, 17):
+                for i in range(len(s) - length + 1):
+                    word = s[i:i + length]
+                    if word not in dictionary:
+                        candidates[word] = candidates.get(word, 0) + 1
+        best, best_saving = None, 0
+        # rough estimate first, exact check for the promising words
+        ranked = sorted(candidates, key=lambda w: (len(w) - 1) * candidates[w], reverse=True)[:32]
+        for word in ranked:
+            if candidates[word] < 2:
+                continue
+            size = sum(len(encode_string(s, dictionary + [word])) for s in strings)
+            saving = current - size - (len(word) + 1 + 2)
+            if saving > best_saving:
+                best, best_saving = word, saving
+        if best is None:
+            break
+        dictionary.append(best)
+    return dictionary
+
+
+def pack(entries):
+    strings = [data for _, data in entries]
+    dictionary = build_dictionary(strings)
+    count = len(strings)
+
+    offset = 4 + 2 * count
+    offsets = []
+    body = bytearray()
+    for s in strings:
+        offsets.append(offset + len(body))
+        body += bytes([len(s)]) + encode_string(s, dictionary)
+
+    dict_offset = offset + len(body)
+    dict_body = bytearray()
+    entry_offsets = []
+    entry_base = dict_offset + 1 + 2 * len(dictionary)
+    for word in dictionary:
+        entry_offsets.append(entry_base + len(dict_body))
+        dict_body += bytes([len(word)]) + word
+
+    blob = bytearray(struct.pack('<HH', count, dict_offset))
+    for o in offsets:
+        blob += struct.pack('<H', o)
+    blob += body
+    blob.append(len(dictionary))
+    for o in entry_offsets:
+        blob += struct.pack('<H', o)
+    blob += dict_body
+    if len(blob) > 0xFFFF:
+        raise ValueError('blob too large')
+    return bytes(blob), dictionary
+
+
+def unpack(blob, index):
+    """Decoder with the same logic as LiquidCrystal_PCF8574_Text::read()."""
+    word = lambda p: blob[p] | (blob[p + 1] << 8)
+    dict_offset = word(2)
+    pos = word(4 + 2 * index)
+    remaining = blob[pos]
+    pos += 1
+    out = bytearray()
+    while len(out) < remaining:
+        t = blob[pos]
+        pos += 1
+        if t == TOKEN_LITERAL:
+            out.append(blob[pos])
+            pos += 1
+        elif t == TOKEN_RUN:
+            out += bytes([blob[pos + 1]]) * blob[pos]
+            pos += 2
+        elif t >= TOKEN_DICT:
+            e = word(dict_offset + 1 + 2 * (t - TOKEN_DICT))
+            out += blob[e + 1:e + 1 + blob[e]]
+        else:
+            out.append(t)
+    return bytes(out)
+
+
+def c_header(name, entries, blob):
+    lines = ['// generated by lcd_text.py', '#include <Arduino.h>', '']
+    for n, (key, _) in enumerate(entries):
+        lines.append('#define %s %d' % (key, n))
+    lines.append('')
+    lines.append('const uint8_t %s[] PROGMEM = {' % name)
+    for i in range(0, len(blob), 16):
+        lines.append('  ' + ', '.join('0x%02x' % b for b in blob[i:i + 16]) + ',')
+    lines.append('};')
+    return '\n'.join(lines) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input')
+    parser.add_argument('-n', '--name', default='lcd_text', help='name of the PROGMEM array')
+    parser.add_argument('-o', '--output', help='output file (default: stdout)')
+    args = parser.parse_args()
+
+    with open(args.input) as f:
+        entries = parse(f.read())
+    blob, dictionary = pack(entries)
+
+    # verify the encoding
+    for n, (_, data) in enumerate(entries):
+        assert unpack(blob, n) == data
+
+    result = c_header(args.name, entries, blob)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(result)
+    else:
+        sys.stdout.write(result)
+    raw = sum(len(data) + 1 for _, data in entries)
+    print('%d strings, %d bytes raw, %d bytes packed, %d dictionary entries'
+          % (len(entries), raw, len(blob), len(dictionary)), file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,287 @@
+#!/usr/bin/env python3
+"""Decode PCF8574 / HD44780 bus traces and export the pin states as VCD.
+
+Input formats (detected automatically):
+
+  * transaction trace, one I2C transaction per line, optionally with a time in microseconds:
+        [@<usec>] W 27 0C 08 ...
+        [@<usec>] R 27 F0
+    This format is written by extras/simavr (lcd_bench -t trace.txt) and by this tool (--trace).
+
+  * sigrok-cli annotations of the I2C decoder, with or without sample numbers:
+        sigrok-cli -i capture.sr -P i2c:scl=D0:sda=D1 -A i2c --protocol-decoder-samplenum
+    e.g. "1000-1010 i2c-1: Address write: 27" / "i2c-1: Data write: 0C" / "i2c-1: Stop"
+
+Outputs:
+
+  --decode          list the HD44780 instructions and data and report timing violations
+  --vcd FILE        pin states RS, RW, E, D4..D7, BL per bus byte as value change dump,
+                    one scope per I2C address
+  --trace FILE      the transactions in the transaction trace format (e.g. to compare a
+                    capture with the byte stream of the driver by diff)
+"""
+
+import argparse
+import re
+import sys
+
+# default pin assignment of the library, see LiquidCrystal_PCF8574(uint8_t i2cAddr)
+PIN_MAPS = {
+    'default': dict(rs=0, rw=1, e=2, bl=3, d4=4, d5=5, d6=6, d7=7),
+    'joyit': dict(rs=4, rw=5, e=7, bl=None, d4=0, d5=1, d6=2, d7=3),
+}
+
+SIGROK_RE = re.compile(r'^(?:(\d+)-(\d+)\s+)?i2c-\d+:\s*(.*)$')
+
+
+class Transaction:
+    def __init__(self, time, kind, addr):
+        self.time = time  # microseconds or None
+        self.kind = kind  # 'W' or 'R'
+        self.addr = addr
+        self.data = []
+        self.times = []  # capture time of every data byte, if known
+
+
+def read_trace(lines):
+    result = []
+    for line in lines:
+        line = line.strip()
+        if not line or line.startswith('#'):
+            continue
+        words = line.split()
+        time = None
+        if words[0].startswith('@'):
+            time = float(words[0][1:])
+            words = words[1:]
+        t = Transaction(time, words[0], int(words[1], 16))
+        t.data = [int(w, 16) for w in words[2:]]
+        result.append(t)
+    return result
+
+
+def read_sigrok(lines, samplerate):
+    result = []
+    current = None
+    for line in lines:
+        m = SIGROK_RE.match(line.strip())
+        if not m:
+            continue
+        time = None
+        if m.group(1) is not None and samplerate:
+            time = int(m.group(1)) * 1e6 / samplerate
+        text = m.group(3)
+        am = re.match(r'Address (write|read): ([0-9A-Fa-f]+)', text)
+        dm = re.match(r'Data (write|read): ([0-9A-Fa-f]+)', text)
+        if am:
+            current = Transaction(time, 'W' if am.group(1) == 'write' else 'R', int(am.group(2), 16))
+            result.append(current)
+        elif dm and current is not None:
+            current.data.append(int(dm.group(2), 16))
+            current.times.append(time)
+        elif text in ('Stop', 'Start repeat', 'Start repeat condition'):
+            current = None
+    return result
+
+
+def read_input(path, samplerate):
+    with open(path) as f:
+        lines = f.readlines()
+    if any(SIGROK_RE.match(line.strip()) for line in lines[:50]):
+        return read_sigrok(lines, samplerate)
+    return read_trace(lines)
+
+
+def bit(value, pin):
+    return 0 if pin is None else (value >> pin) & 1
+
+
+class Decoder:
+    """Follows the E line of one adapter and assembles 4-bit transfers like the HD44780 does."""
+
+    def __init__(self, pins, out, name=''):
+        self.pins = pins
+        self.out = out
+        self.name = name  # prefix of the reported lines, e.g. the address
+        self.last = None
+        self.high = None
+        self.status = 0  # nibbles of the busy flag and address counter read with RW high
+        self.violations = 0
+
+    def nibble(self, value):
+        p = self.pins
+        return bit(value, p['d4']) | bit(value, p['d5']) << 1 | bit(value, p['d6']) << 2 | bit(value, p['d7']) << 3
+
+    def byte(self, time, value):
+        p = self.pins
+        last = self.last
+        self.last = value
+        if not bit(value, p['rw']):
+            self.status = 0
+        if last is None:
+            return
+        e0, e1 = bit(last, p['e']), bit(value, p['e'])
+        if not e0 and e1 and bit(value, p['rw']):
+            self.status += 1
+        if not e0 and e1:
+            # RS and RW must be stable before E rises
+            if bit(last, p['rs']) != bit(value, p['rs']) or bit(last, p['rw']) != bit(value, p['rw']):
+                self.violations += 1
+                self.report(time, 'VIOLATION: RS/RW changed together with E rising')
+        if e0 and not e1 and not bit(value, p['rw']):
+            n = self.nibble(last)
+            if self.high is None:
+                self.high = n
+            else:
+                self.instruction(time, bit(last, p['rs']), self.high << 4 | n)
+                self.high = None
+
+    def read(self, time, value):
+        p = self.pins
+        last = self.last
+        # only the first nibble of a status read (E high, RW high, RS low) has the busy flag on D7,
+        # reads with E low are reads of the port, e.g. of buttons
+        if last is None or not bit(last, p['e']) or not bit(last, p['rw']) or bit(last, p['rs']):
+            return
+        if self.status % 2 == 1 and bit(value, p['d7']):
+            self.report(time, 'read: busy')
+
+    def report(self, time, text):
+        if self.out:
+            prefix = '%12.1f  ' % time if time is not None else ''
+            self.out.write(prefix + self.name + text + '\n')
+
+    def instruction(self, time, rs, v):
+        if rs:
+            text = 'data  0x%02x %s' % (v, repr(chr(v)) if 32 <= v < 127 else '')
+        elif v & 0x80:
+            text = 'Set DDRAM address 0x%02x' % (v & 0x7f)
+        elif v & 0x40:
+            text = 'Set CGRAM address 0x%02x' % (v & 0x3f)
+        elif v & 0x20:
+            text = 'Function set 0x%02x' % v
+        elif v & 0x10:
+            text = '%s shift %s' % ('Display' if v & 0x08 else 'Cursor', 'right' if v & 0x04 else 'left')
+        elif v & 0x08:
+            text = 'Display control D=%d C=%d B=%d' % ((v >> 2) & 1, (v >> 1) & 1, v & 1)
+        elif v & 0x04:
+            text = 'Entry mode I/D=%d S=%d' % ((v >> 1) & 1, v & 1)
+        elif v & 0x02:
+            text = 'Return home'
+        elif v & 0x01:
+            text = 'Clear display'
+        else:
+            text = 'NOP'
+        self.report(time, text)
+
+
+def byte_times(transactions, clock):
+    """Time of every byte: from the capture or 9 clock cycles per byte."""
+    byte_us = 9 * 1e6 / clock
+    now = 0.0
+    for t in transactions:
+        if t.time is not None:
+            now = max(now, t.time)
+        now += byte_us  # address byte
+        for i, value in enumerate(t.data):
+            if i < len(t.times) and t.times[i] is not None:
+                now = t.times[i]
+            yield now, t, value
+            now += byte_us
+
+
+def write_vcd(f, transactions, pins, clock):
+    names = [('rs', 'RS'), ('rw', 'RW'), ('e', 'E'), ('d4', 'D4'), ('d5', 'D5'), ('d6', 'D6'), ('d7', 'D7'), ('bl', 'BL')]
+    names = [(k, n) for k, n in names if pins[k] is not None]
+    addresses = sorted(set(t.addr for t in transactions if t.kind == 'W'))
+    ids = {}
+    f.write('$timescale 1us $end\n')
+    for a, addr in enumerate(addresses):
+        # every address is a module with its own pins
+        f.write('$scope module pcf8574_%02x $end\n' % addr)
+        for i, (k, n) in enumerate(names):
+            ids[addr, k] = vcd_id(a * len(names) + i)
+            f.write('$var wire 1 %s %s $end\n' % (ids[addr, k], n))
+        f.write('$upscope $end\n')
+    f.write('$enddefinitions $end\n')
+    last = {}
+    stamp = None
+    for time, t, value in byte_times(transactions, clock):
+        if t.kind != 'W':
+            continue
+        prev = last.get(t.addr)
+        changes = [(k, bit(value, pins[k])) for k, _ in names if prev is None or bit(prev, pins[k]) != bit(value, pins[k])]
+        if changes:
+            if round(time) != stamp:
+                stamp = round(time)
+                f.write('#%d\n' % stamp)
+            for k, v in changes:
+                f.write('%d%s\n' % (v, ids[t.addr, k]))
+        last[t.addr] = value
+
+
+def vcd_id(n):
+    """Identifier of a VCD variable from the printable characters."""
+    text = chr(33 + n % 94)
+    while n >= 94:
+        n = n // 94 - 1
+        text += chr(33 + n % 94)
+    return text
+
+
+def decode(transactions, pins, clock, out):
+    """Decode the transactions with one decoder per address, returns the decoders by address."""
+    decoders = {}
+    several = len(set(t.addr for t in transactions)) > 1
+    for time, t, value in byte_times(transactions, clock):
+        decoder = decoders.get(t.addr)
+        if decoder is None:
+            decoder = decoders[t.addr] = Decoder(pins, out, '%02X: ' % t.addr if several else '')
+        if t.kind == 'W':
+            decoder.byte(time, value)
+        else:
+            decoder.read(time, value)
+    return decoders
+
+
+def write_trace(f, transactions):
+    for t in transactions:
+        prefix = '@%.1f ' % t.time if t.time is not None else ''
+        f.write('%s%s %02X %s\n' % (prefix, t.kind, t.addr, ' '.join('%02X' % b for b in t.data)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input')
+    parser.add_argument('--address', type=lambda s: int(s, 0), help='only use this I2C address (default: all)')
+    parser.add_argument('--map', choices=sorted(PIN_MAPS), default='default', help='pin assignment of the adapter')
+    parser.add_argument('--samplerate', type=float, help='sample rate of a sigrok capture in Hz')
+    parser.add_argument('--clock', type=float, default=100000, help='I2C clock for times that are not captured')
+    parser.add_argument('--decode', action='store_true', help='list instructions, data and timing violations')
+    parser.add_argument('--vcd', metavar='FILE', help='write the pin states as VCD')
+    parser.add_argument('--trace', metavar='FILE', help='write the transaction trace')
+    args = parser.parse_args()
+
+    transactions = read_input(args.input, args.samplerate)
+    if args.address is not None:
+        transactions = [t for t in transactions if t.addr == args.address]
+    pins = PIN_MAPS[args.map]
+
+    if args.trace:
+        with open(args.trace, 'w') as f:
+            write_trace(f, transactions)
+    if args.vcd:
+        with open(args.vcd, 'w') as f:
+            write_vcd(f, transactions, pins, args.clock)
+
+    decoders = decode(transactions, pins, args.clock, sys.stdout if args.decode else None)
+    violations = sum(d.violations for d in decoders.values())
+
+    written = sum(len(t.data) for t in transactions if t.kind == 'W')
+    print('%d transactions, %d bytes written, %d timing violations'
+          % (len(transactions), written, violations), file=sys.stderr)
+    return 1 if violations else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
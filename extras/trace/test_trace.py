@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Tests of pcf8574_trace.py with a fixed transaction trace of two adapters."""
+
+import io
+import unittest
+
+import pcf8574_trace as trace
+
+# Two adapters with the default pin assignment and the backlight on (0x08), E is 0x04, RW 0x02.
+# The nibbles of their instructions are interleaved on the bus.
+TRACE = '''
+# Clear display to 27, Return home to 26
+@0 W 27 0C 08
+@100 W 26 0C 08
+@200 W 27 1C 18
+@300 W 26 2C 28
+# 27: busy flag and address counter, like waitBusy() and _readStatus()
+@400 W 27 FA FE
+@500 R 27 8A
+@600 W 27 FA FE
+@700 R 27 8A
+@800 W 27 FA 08
+# 27: a read of buttons with E low, D7 is high
+@900 R 27 F8
+# 26: RS changes together with E rising
+@1000 W 26 08 0D 09
+'''
+
+
+def vcd_changes(text):
+    """The values of every variable by scope and name."""
+    ids = {}
+    values = {}
+    scope = None
+    for line in text.splitlines():
+        words = line.split()
+        if words[:2] == ['$scope', 'module']:
+            scope = words[2]
+        elif words[:1] == ['$var']:
+            ids[words[3]] = (scope, words[4])
+            values[scope, words[4]] = []
+        elif line and line[0] in '01' and line[1:] in ids:
+            values[ids[line[1:]]].append(int(line[0]))
+    return ids, values
+
+
+class DecodeTest(unittest.TestCase):
+
+    def setUp(self):
+        self.transactions = trace.read_trace(TRACE.splitlines())
+        self.pins = trace.PIN_MAPS['default']
+
+    def test_decoder_per_address(self):
+        out = io.StringIO()
+        decoders = trace.decode(self.transactions, self.pins, 100000, out)
+        self.assertEqual(sorted(decoders), [0x26, 0x27])
+        self.assertEqual([line[14:] for line in out.getvalue().splitlines()], [
+            '27: Clear display',
+            '26: Return home',
+            '27: read: busy',
+            '26: VIOLATION: RS/RW changed together with E rising',
+        ])
+        self.assertEqual(decoders[0x26].violations, 1)
+        self.assertEqual(decoders[0x27].violations, 0)
+
+    def test_single_address(self):
+        out = io.StringIO()
+        transactions = [t for t in self.transactions if t.addr == 0x27]
+        trace.decode(transactions, self.pins, 100000, out)
+        self.assertEqual([line[14:] for line in out.getvalue().splitlines()], ['Clear display', 'read: busy'])
+
+    def test_vcd_scope_per_address(self):
+        out = io.StringIO()
+        trace.write_vcd(out, self.transactions, self.pins, 100000)
+        ids, values = vcd_changes(out.getvalue())
+        self.assertEqual(len(ids), 16)
+        self.assertEqual(values['pcf8574_26', 'E'], [1, 0, 1, 0, 1, 0])
+        self.assertEqual(values['pcf8574_26', 'D5'], [0, 1, 0])
+        self.assertEqual(values['pcf8574_27', 'E'], [1, 0, 1, 0, 1, 0, 1, 0])
+        self.assertEqual(values['pcf8574_27', 'RW'], [0, 1, 0])
+
+    def test_vcd_id(self):
+        self.assertEqual(trace.vcd_id(0), '!')
+        self.assertEqual(len(set(trace.vcd_id(n) for n in range(1000))), 1000)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -10,12 +10,39 @@
 
 #include <Wire.h>
 
+#define LCD_ADDR_UNKNOWN 0xFF
+
+// maximum time waitBusy() polls the busy flag in microseconds
+#define LCD_BUSY_TIMEOUT 10000
+
+// time in milliseconds a button level must be stable
+#define LCD_BUTTON_DEBOUNCE 20
+
+// pollButtons() reads the buttons when they were not sampled for this time in milliseconds
+#define LCD_BUTTON_POLL 5
+
+// SerLCD backpack: prefix of an HD44780 instruction, prefix of a setting, settings
+#define LCD_SERLCD_COMMAND 0xFE
+#define LCD_SERLCD_SETTING 0x7C
+#define LCD_SERLCD_BACKLIGHT 128 ///< 128..157 backlight brightness
+#define LCD_SERLCD_DEFINE 27 ///< 27..34 define a custom character
+#define LCD_SERLCD_CHAR 35 ///< 35..42 show a custom character
+
 LiquidCrystal_PCF8574::LiquidCrystal_PCF8574(uint8_t i2cAddr)
 {
   // default pin assignment
   init(i2cAddr, 0, 1, 2, 4, 5, 6, 7, 3);
 } // LiquidCrystal_PCF8574
 
+/// Use a SerLCD compatible backpack on a serial port instead of the PCF8574.
+/// The port must be started (e.g. Serial1.begin(9600)) before begin().
+LiquidCrystal_PCF8574::LiquidCrystal_PCF8574(Print &serial)
+{
+  init(0, 0, 255, 2, 4, 5, 6, 7, 255);
+  _serial = &serial;
+  _spare_mask = 0;
+} // LiquidCrystal_PCF8574
+
 LiquidCrystal_PCF8574::LiquidCrystal_PCF8574(uint8_t i2cAddr, enum LiquidCrystal_PCF8574_type type)
 {
   switch (type) {
@@ -48,7 +75,15 @@ void LiquidCrystal_PCF8574::init(uint8_t i2cAddr, uint8_t rs, uint8_t rw, uint8_
     uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7, uint8_t backlight)
 {
   _i2cAddr = i2cAddr;
+  _serial = NULL;
   _backlight = 0;
+  _cols = 0;
+  _lines = 0;
+  _row = 0;
+  _addr = 0;
+  _shift = 0;
+  _error = 0;
+  _rs_state = false; // transfers before begin() set RS LOW
 
   _entrymode = 0x02; // like Initializing by Internal Reset Circuit
   _displaycontrol = 0x04;
@@ -68,15 +103,31 @@ void LiquidCrystal_PCF8574::init(uint8_t i2cAddr, uint8_t rs, uint8_t rw, uint8_
     _backlight_mask = 0x01 << backlight;
   else
     _backlight_mask = 0;
+
+  // the pins that are not connected to the display can be used as outputs
+  _spare_mask = ~(_rs_mask | _rw_mask | _enable_mask | _backlight_mask
+    | _data_mask[0] | _data_mask[1] | _data_mask[2] | _data_mask[3]);
+  _spare = 0;
+  _sparePending = false;
+  _input_mask = 0;
 } // init()
 
 
 void LiquidCrystal_PCF8574::begin(uint8_t cols, uint8_t lines)
 {
-  // _cols = cols ignored !
-  _lines = lines;
+  LiquidCrystal_PCF8574 *display = this;
+  begin(&display, 1, cols, lines);
+} // begin()
 
+
+/// Initialize a group of displays on the same bus.
+/// Every step of the reset sequence is sent to all displays before the common waiting time,
+/// so the time does not grow with the number of displays.
+void LiquidCrystal_PCF8574::begin(LiquidCrystal_PCF8574 *displays[], uint8_t count, uint8_t cols, uint8_t lines)
+{
+  uint8_t n;
   uint8_t functionFlags = 0;
+  bool wire = false; // some displays are connected by a PCF8574
 
   if (lines > 1) {
     functionFlags |= 0x08;
@@ -88,44 +139,143 @@ void LiquidCrystal_PCF8574::begin(uint8_t cols, uint8_t lines)
   if ((TWCR & _BV(TWEN)) != _BV(TWEN))
 #endif
     Wire.begin();
-  _write2Wire(0x00);
-  _rs_state = true;
-  delayMicroseconds(50000);
 
-  // after reset the mode is this
-  _displaycontrol = 0x04;
-  _entrymode = 0x02;
+  for (n = 0; n < count; n++) {
+    LiquidCrystal_PCF8574 *d = displays[n];
+    d->_cols = cols;
+    d->_lines = lines;
+    d->_row = 0;
+    d->_rs_state = true;
+    d->_write2Wire(0x00);
+
+    // after reset the mode is this
+    d->_displaycontrol = 0x04;
+    d->_entrymode = 0x02;
+    d->_addr = 0;
+    d->_shift = 0;
+    if (!d->_serial)
+      wire = true;
+  }
 
-  // sequence to reset. see "Initializing by Instruction" in datatsheet
-  _sendNibble(0x03);
-  delayMicroseconds(4500);
-  _sendNibble(0x03);
-  delayMicroseconds(200);
-  _sendNibble(0x03);
-  delayMicroseconds(200);
-  _sendNibble(0x02);   // finally, set to 4-bit interface
+  if (wire) {
+    delayMicroseconds(50000);
+
+    // sequence to reset. see "Initializing by Instruction" in datatsheet
+    for (n = 0; n < count; n++)
+      displays[n]->_sendNibble(0x03);
+    delayMicroseconds(4500);
+    for (n = 0; n < count; n++)
+      displays[n]->_sendNibble(0x03);
+    delayMicroseconds(200);
+    for (n = 0; n < count; n++)
+      displays[n]->_sendNibble(0x03);
+    delayMicroseconds(200);
+  }
 
-  // Instruction: Function set = 0x20
-  _send(0x20 | functionFlags);
+  for (n = 0; n < count; n++) {
+    LiquidCrystal_PCF8574 *d = displays[n];
+    d->_sendNibble(0x02); // finally, set to 4-bit interface
 
-  display();
-  clear();
-  leftToRight();
+    // Instruction: Function set = 0x20
+    d->_send(0x20 | functionFlags);
+
+    d->display();
+  }
+  clear(displays, count);
+
+  for (n = 0; n < count; n++)
+    displays[n]->leftToRight();
 } // begin()
 
 
+/// Initialize a display that may have kept its power while the processor restarted.
+/// With the RW line connected the display is probed: when it is in 4-bit mode and answers
+/// consistently only the modes are applied and the content stays on the display.
+/// Otherwise the complete begin() is done. Returns true when the content was kept.
+bool LiquidCrystal_PCF8574::beginWarm(uint8_t cols, uint8_t lines)
+{
+  if (_serial) {
+    // the backpack keeps the display initialized
+    _cols = cols;
+    _lines = lines;
+    _row = 0;
+    display();
+    leftToRight();
+    home();
+    return true;
+  }
+
+  if (_rw_mask == 0) {
+    begin(cols, lines);
+    return false;
+  }
+
+#ifdef __AVR__
+  // Do not re-initialize and overwrite user settings.
+  if ((TWCR & _BV(TWEN)) != _BV(TWEN))
+#endif
+    Wire.begin();
+
+  _cols = cols;
+  _lines = lines;
+  _row = 0;
+  _rs_state = true;
+  _write2Wire(0x00);
+
+  // An address that shows in both nibbles of the status tells a display in 4-bit mode apart
+  // from one in 8-bit mode (that returns the high nibble twice) or one waiting for a second nibble.
+  // In the other cases the instruction may change some modes, but the complete begin() follows anyway.
+  if ((_readStatus() < 0) || (_error != 0)) {
+    _error = 0;
+    begin(cols, lines);
+    return false;
+  }
+  _send(0x80 | 0x01);
+  if ((_readStatus() != 0x01) || (_readStatus() != 0x01)) {
+    _error = 0;
+    begin(cols, lines);
+    return false;
+  }
+
+  // Instruction: Function set = 0x20
+  _send(0x20 | ((lines > 1) ? 0x08 : 0x00));
+  _displaycontrol = 0x04;
+  _send(0x08 | _displaycontrol);
+  _entrymode = 0x02;
+  _send(0x04 | _entrymode);
+
+  // the display shift is not known: Return home shifts back without clearing
+  home();
+  return true;
+} // beginWarm()
+
+
 void LiquidCrystal_PCF8574::clear()
 {
   // Instruction: Clear display = 0x01
   _send(0x01);
+  _row = 0;
   waitBusy();
 } // clear()
 
 
+/// Clear a group of displays and wait for all of them once.
+void LiquidCrystal_PCF8574::clear(LiquidCrystal_PCF8574 *displays[], uint8_t count)
+{
+  for (uint8_t n = 0; n < count; n++) {
+    // Instruction: Clear display = 0x01
+    displays[n]->_send(0x01);
+    displays[n]->_row = 0;
+  }
+  _waitBusy(displays, count);
+} // clear()
+
+
 void LiquidCrystal_PCF8574::home()
 {
   // Instruction: Return home = 0x02
   _send(0x02);
+  _row = 0;
   waitBusy();
 } // home()
 
@@ -134,6 +284,7 @@ void LiquidCrystal_PCF8574::home()
 void LiquidCrystal_PCF8574::setCursor(uint8_t col, uint8_t row)
 {
   uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54};
+  _row = row;
   // Instruction: Set DDRAM address = 0x80
   _send(0x80 | (row_offsets[row] + col));
 } // setCursor()
@@ -207,6 +358,22 @@ void LiquidCrystal_PCF8574::scrollDisplayRight(void)
 } // scrollDisplayRight()
 
 
+void LiquidCrystal_PCF8574::moveCursorLeft(void)
+{
+  // Instruction: Cursor or display shift = 0x10
+  // cursor: 0x00, left: 0x00
+  _send(0x10 | 0x00 | 0x00);
+} // moveCursorLeft()
+
+
+void LiquidCrystal_PCF8574::moveCursorRight(void)
+{
+  // Instruction: Cursor or display shift = 0x10
+  // cursor: 0x00, right: 0x04
+  _send(0x10 | 0x00 | 0x04);
+} // moveCursorRight()
+
+
 // == controlling the entrymode
 
 // This is for text that flows Left to Right
@@ -251,35 +418,131 @@ void LiquidCrystal_PCF8574::noAutoscroll(void)
 void LiquidCrystal_PCF8574::setBacklight(uint8_t brightness)
 {
   _backlight = brightness;
+  if (_serial) {
+    uint8_t setting[2] = { LCD_SERLCD_SETTING, (uint8_t)(LCD_SERLCD_BACKLIGHT + (uint16_t)brightness * 29 / 255) };
+    _serial->write(setting, 2);
+    return;
+  }
   // send no data but set the background-pin right;
   _write2Wire(0x00);
 } // setBacklight()
 
 
-#ifdef __AVR__
+/// Set a pin of the PCF8574 that is not connected to the display.
+/// The state is part of every byte sent to the display.
+/// With defer set it is only sent with the next transfer or by flushSparePins().
+void LiquidCrystal_PCF8574::setSparePin(uint8_t pin, bool value, bool defer)
+{
+  if (pin > 7)
+    return;
+  uint8_t mask = (0x01 << pin) & _spare_mask & ~_input_mask;
+  uint8_t spare = value ? (_spare | mask) : (_spare & ~mask);
+
+  if (spare != _spare) {
+    _spare = spare;
+    _sparePending = true;
+  }
+  if (!defer)
+    flushSparePins();
+} // setSparePin()
+
+
+/// Send changed spare pins that did not go out with a transfer to the display.
+void LiquidCrystal_PCF8574::flushSparePins()
+{
+  if (_sparePending)
+    _write2Wire(0x00);
+} // flushSparePins()
+
+
+/// Use spare pins as inputs for buttons that connect the pin to GND.
+/// The pins are set HIGH so the buttons can pull them LOW.
+void LiquidCrystal_PCF8574::setButtonPins(uint8_t pins)
+{
+  // pins that are no longer buttons go back to LOW like the other spare pins
+  _spare &= ~_input_mask;
+  _input_mask = pins & _spare_mask;
+  _spare |= _input_mask;
+  _sparePending = true;
+  _raw = _stable = _input_mask;
+  _pressed = _released = 0;
+  _sampleTime = millis();
+  flushSparePins();
+} // setButtonPins()
+
+
+/// Read the buttons when no read of the busy flag has sampled them recently.
+/// Returns the pressed buttons.
+uint8_t LiquidCrystal_PCF8574::pollButtons()
+{
+  if ((_input_mask != 0) && (millis() - _sampleTime >= LCD_BUTTON_POLL)) {
+    if (Wire.requestFrom(_i2cAddr, uint8_t(1)) == 1)
+      _sample(Wire.read());
+  }
+  return buttons();
+} // pollButtons()
+
+
+/// Return and reset the buttons that were pressed since the last call.
+uint8_t LiquidCrystal_PCF8574::buttonPresses()
+{
+  uint8_t pressed = _pressed;
+  _pressed = 0;
+  return pressed;
+} // buttonPresses()
+
+
+/// Return and reset the buttons that were released since the last call.
+uint8_t LiquidCrystal_PCF8574::buttonReleases()
+{
+  uint8_t released = _released;
+  _released = 0;
+  return released;
+} // buttonReleases()
+
+
 // Allows us to fill the first 8 CGRAM locations
 // with custom characters
 void LiquidCrystal_PCF8574::createChar(uint8_t location, byte charmap[])
 {
   location &= 0x7; // we only have 8 locations 0-7
+  if (_serial) {
+    uint8_t setting[2] = { LCD_SERLCD_SETTING, (uint8_t)(LCD_SERLCD_DEFINE + location) };
+    _serial->write(setting, 2);
+    _serial->write(charmap, 8);
+    _addr = LCD_ADDR_UNKNOWN;
+    return;
+  }
+  // The character generator RAM is written in the entry mode like the display RAM:
+  // the bitmap needs increment and no display shift, the entry mode of the application is restored afterwards.
+  uint8_t entrymode = _entrymode;
+  if (entrymode != 0x02)
+    _send(0x04 | 0x02);
   // Set CGRAM address
   _send(0x40 | (location << 3));
-  for (int i = 0; i < 8; i++) {
-    write(charmap[i]);
-  }
+  write(charmap, 8);
+  if (entrymode != 0x02)
+    _send(0x04 | entrymode);
 } // createChar()
 
 
+// Define a character while the application keeps writing to the display RAM.
+void LiquidCrystal_PCF8574::preloadChar(uint8_t location, byte charmap[])
+{
+  uint8_t addr = _addr;
+  createChar(location, charmap);
+  if (addr != LCD_ADDR_UNKNOWN)
+    _send(0x80 | addr);
+} // preloadChar()
+
+
+#ifdef __AVR__
 // Allows us to fill the first 8 CGRAM locations
 // with custom characters stored in PROGMEM
 void LiquidCrystal_PCF8574::createCharPgm(uint8_t location, const byte *charmap) {
-  PGM_P p = reinterpret_cast<PGM_P>(charmap);
-  location &= 0x7; // we only have 8 locations 0-7
-  _send(0x40 | (location << 3));
-  for (int i = 0; i < 8; i++) {
-    byte c = pgm_read_byte(p++);
-    write(c);
-  }
+  byte data[8];
+  memcpy_P(data, charmap, 8);
+  createChar(location, data);
 } // createCharPgm()
 #endif
 
@@ -297,9 +560,15 @@ size_t LiquidCrystal_PCF8574::write(const uint8_t *buffer, size_t size) {
   uint8_t out, out1;
   uint8_t c = 0;
 
+  if (_serial) {
+    _writeSerial(buffer, size);
+    while (n--)
+      _advance();
+    return size;
+  }
+
   out = _rs_mask;  // RS==HIGH
-  if (_backlight > 0)
-    out |= _backlight_mask;
+  out |= _idlePins();
   out1 = out;
 
   while (size--) {
@@ -332,25 +601,260 @@ size_t LiquidCrystal_PCF8574::write(const uint8_t *buffer, size_t size) {
     // pulse enable
     Wire.write(out | _enable_mask);
     Wire.write(out);
+    _advance();
     c += 4;
-    if (c >= BUFFER_LENGTH - 4) {
+    if (c >= 4 * LCD_CHARS_PER_TRANSMISSION) {
       // We only restart the transmission once the buffer is full.
-      Wire.endTransmission();
+      _endTransmission();
       c = 0;
     }
   }
-  if (c != 0) Wire.endTransmission();
+  if (c != 0) _endTransmission();
   return n;
 }
 
 
+/// Forward the bytes that are available from a stream to the display.
+/// The bytes are read in chunks that fit into one Wire transmission and are sent by write(buffer, size).
+/// The function never waits for more data and returns the number of bytes consumed from the stream.
+/// With lineHandling a '\n' moves the cursor to the start of the next row and '\r' is ignored.
+size_t LiquidCrystal_PCF8574::pumpFrom(Stream &stream, size_t maxBytes, bool lineHandling)
+{
+  uint8_t chunk[LCD_CHARS_PER_TRANSMISSION];
+  size_t n = 0;
+
+  while (n < maxBytes) {
+    int avail = stream.available();
+    if (avail <= 0)
+      break;
+
+    size_t len = sizeof(chunk);
+    if ((size_t)avail < len) len = avail;
+    if (maxBytes - n < len) len = maxBytes - n;
+    len = stream.readBytes(chunk, len);
+    if (len == 0)
+      break;
+    n += len;
+
+    if (!lineHandling) {
+      write(chunk, len);
+      continue;
+    }
+
+    // send the runs between line breaks
+    size_t start = 0;
+    for (size_t i = 0; i < len; i++) {
+      uint8_t c = chunk[i];
+      if ((c == '\n') || (c == '\r')) {
+        if (i > start)
+          write(chunk + start, i - start);
+        if (c == '\n')
+          setCursor(0, (_lines > 0) ? (_row + 1) % _lines : 0);
+        start = i + 1;
+      }
+    }
+    if (len > start)
+      write(chunk + start, len - start);
+  }
+  return n;
+} // pumpFrom()
+
+
+/// Write characters to a position on the visible display.
+/// The position is mapped to the display RAM by the tracked display shift.
+/// With rightToLeft() the characters are sent in reverse order and an active autoscroll()
+/// is suspended while writing, so the text always appears left to right at col, row.
+/// The cursor is only set when the address counter is not already at the right position.
+size_t LiquidCrystal_PCF8574::writeAt(uint8_t col, uint8_t row, const uint8_t *buffer, size_t size)
+{
+  return _writeAt(_shift, col, row, buffer, size);
+} // writeAt()
+
+
+/// The number of display RAM pages.
+/// Displays with 2 lines and up to 20 columns (or 1 line and up to 40 columns) have a second page
+/// in the part of the display RAM that is not visible.
+uint8_t LiquidCrystal_PCF8574::pageCount()
+{
+  if ((_lines <= 2) && (_cols > 0) && (_cols <= _pageOffset()))
+    return 2;
+  return 1;
+} // pageCount()
+
+
+/// The page that is visible or 0xFF when the display is shifted to another position.
+uint8_t LiquidCrystal_PCF8574::visiblePage()
+{
+  if (_shift == 0)
+    return 0;
+  if ((pageCount() > 1) && (_shift == _pageOffset()))
+    return 1;
+  return 0xFF;
+} // visiblePage()
+
+
+/// Write characters to a position of a page like writeAt() does for the visible display.
+size_t LiquidCrystal_PCF8574::writePage(uint8_t page, uint8_t col, uint8_t row, const uint8_t *buffer, size_t size)
+{
+  if (page >= pageCount())
+    return 0;
+  return _writeAt(page * _pageOffset(), col, row, buffer, size);
+} // writePage()
+
+
+/// Make a page visible.
+void LiquidCrystal_PCF8574::showPage(uint8_t page)
+{
+  uint8_t instruction;
+  uint8_t steps = _pageShift(page, &instruction);
+
+  if (steps > 0) {
+    _sendRepeated(instruction, steps);
+    if (instruction == 0x02)
+      waitBusy();
+  }
+} // showPage()
+
+
+/// Make a page visible on a group of displays at practically the same time.
+/// The shift instructions of a display are packed into transmissions like _sendRepeated() does.
+/// Every round sends one transmission to every display that needs it; a display that needs fewer
+/// instructions starts in a later round. The last instruction of every display is kept for the last round,
+/// so the displays move together and all reach the page within one instruction per display.
+void LiquidCrystal_PCF8574::showPage(LiquidCrystal_PCF8574 *displays[], uint8_t count, uint8_t page)
+{
+  uint8_t instruction;
+  uint8_t rounds = 0;
+  bool wait = false;
+  uint8_t n;
+
+  for (n = 0; n < count; n++) {
+    uint8_t steps = displays[n]->_pageShift(page, &instruction);
+    if (steps > 0) {
+      uint8_t r = 1 + (steps - 1 + LCD_CHARS_PER_TRANSMISSION - 1) / LCD_CHARS_PER_TRANSMISSION;
+      if (r > rounds)
+        rounds = r;
+    }
+  }
+
+  for (; rounds > 0; rounds--) {
+    for (n = 0; n < count; n++) {
+      uint8_t steps = displays[n]->_pageShift(page, &instruction);
+      if (steps == 0)
+        continue;
+      if (rounds > 1) {
+        // the instructions before the last one that do not fit into the rounds after this one
+        uint8_t later = (rounds - 2) * LCD_CHARS_PER_TRANSMISSION;
+        steps = (steps - 1 > later) ? steps - 1 - later : 0;
+      }
+      if (steps > 0) {
+        displays[n]->_sendRepeated(instruction, steps);
+        wait |= (instruction == 0x02);
+      }
+    }
+  }
+
+  if (wait)
+    _waitBusy(displays, count);
+} // showPage()
+
+
+// The number of instructions to shift the display to a page and the instruction.
+// Page 0 is reached by a single Return home that resets the shift.
+uint8_t LiquidCrystal_PCF8574::_pageShift(uint8_t page, uint8_t *instruction)
+{
+  if ((page >= pageCount()) || (page == visiblePage()))
+    return 0;
+
+  if (page == 0) {
+    // Instruction: Return home = 0x02
+    *instruction = 0x02;
+    return 1;
+  }
+
+  // Instruction: Cursor or display shift = 0x10, shift: 0x08, right: 0x04
+  uint8_t lineLen = 2 * _pageOffset();
+  uint8_t left = (_pageOffset() + lineLen - _shift) % lineLen;
+  if (left <= lineLen / 2) {
+    *instruction = 0x10 | 0x08;
+    return left;
+  }
+  *instruction = 0x10 | 0x08 | 0x04;
+  return lineLen - left;
+} // _pageShift()
+
+
+// Write characters to a position relative to a display RAM offset.
+size_t LiquidCrystal_PCF8574::_writeAt(uint8_t offset, uint8_t col, uint8_t row, const uint8_t *buffer, size_t size)
+{
+  uint8_t entrymode = _entrymode;
+  bool increment = (entrymode & 0x02);
+  uint8_t lineLen = (_lines > 1) ? 40 : 80;
+  uint8_t chunk[LCD_CHARS_PER_TRANSMISSION];
+  size_t done = 0;
+
+  // the display must not move while writing
+  if (entrymode & 0x01)
+    _send(0x04 | (entrymode & ~0x01));
+
+  while (done < size) {
+    size_t remaining = size - done;
+    uint8_t addr, pos, n;
+
+    if (increment) {
+      // from the left to the end of the display line
+      addr = _address(offset, col + done, row);
+      pos = (_lines > 1) ? (addr & 0x3F) : addr;
+      n = (remaining < (size_t)(lineLen - pos)) ? remaining : lineLen - pos;
+      if (addr != _addr)
+        _send(0x80 | addr);
+      write(buffer + done, n);
+
+    } else {
+      // from the right to the start of the display line
+      addr = _address(offset, col + remaining - 1, row);
+      pos = (_lines > 1) ? (addr & 0x3F) : addr;
+      n = (remaining < (size_t)(pos + 1)) ? remaining : pos + 1;
+      if (addr != _addr)
+        _send(0x80 | addr);
+      const uint8_t *p = buffer + remaining;
+      for (uint8_t i = 0; i < n;) {
+        uint8_t len = 0;
+        while ((len < sizeof(chunk)) && (i < n)) {
+          chunk[len++] = *--p;
+          i++;
+        }
+        write(chunk, len);
+      }
+    }
+    done += n;
+  }
+
+  if (entrymode & 0x01)
+    _send(0x04 | entrymode);
+  return size;
+} // _writeAt()
+
+
 // write either command or data
 void LiquidCrystal_PCF8574::_send(uint8_t value, bool isData)
 {
   uint8_t out = 0, out1;
 
-  if (_backlight > 0)
-    out |= _backlight_mask;
+  if (_serial) {
+    if (isData) {
+      _writeSerial(&value, 1);
+      _advance();
+    } else if ((value & 0xE0) != 0x20) {
+      // the backpack owns the function set
+      uint8_t command[2] = { LCD_SERLCD_COMMAND, value };
+      _serial->write(command, 2);
+      _track(value);
+    }
+    return;
+  }
+
+  out |= _idlePins();
   if (isData)
     out |= _rs_mask;
 
@@ -379,20 +883,81 @@ void LiquidCrystal_PCF8574::_send(uint8_t value, bool isData)
   // pulse enable
   Wire.write(out | _enable_mask);
   Wire.write(out);
-  Wire.endTransmission();
+  _endTransmission();
+
+  if (isData)
+    _advance();
+  else
+    _track(value);
 } // _send()
 
 
+// send an instruction several times with as few transmissions as possible
+void LiquidCrystal_PCF8574::_sendRepeated(uint8_t value, uint8_t count)
+{
+  uint8_t out = 0, out1;
+  uint8_t c = 0;
+
+  if (_serial) {
+    while (count--)
+      _send(value);
+    return;
+  }
+
+  out |= _idlePins();
+
+  out1 = out;
+  if (value & 0x10) out |= _data_mask[0];
+  if (value & 0x20) out |= _data_mask[1];
+  if (value & 0x40) out |= _data_mask[2];
+  if (value & 0x80) out |= _data_mask[3];
+  uint8_t high = out;
+
+  out = out1;
+  if (value & 0x01) out |= _data_mask[0];
+  if (value & 0x02) out |= _data_mask[1];
+  if (value & 0x04) out |= _data_mask[2];
+  if (value & 0x08) out |= _data_mask[3];
+  uint8_t low = out;
+
+  while (count--) {
+    if (c == 0) {
+      Wire.beginTransmission(_i2cAddr);
+      if (_rs_state) {
+        // Change RS line before ENABLE.
+        Wire.write(high);
+        _rs_state = false;
+      }
+    }
+    // pulse enable
+    Wire.write(high | _enable_mask);
+    Wire.write(high);
+    Wire.write(low | _enable_mask);
+    Wire.write(low);
+    _track(value);
+    c += 4;
+    if (c >= BUFFER_LENGTH - 4) {
+      _endTransmission();
+      c = 0;
+    }
+  }
+  if (c != 0) _endTransmission();
+} // _sendRepeated()
+
+
 // write a nibble / halfByte with handshake
 void LiquidCrystal_PCF8574::_sendNibble(uint8_t value, bool isData)
 {
   // map the given values to the hardware of the I2C schema
   uint8_t out = 0;
+
+  // the backpack has initialized the display interface
+  if (_serial)
+    return;
   if (isData)
     out |= _rs_mask;
   // _rw_mask is not used here.
-  if (_backlight > 0)
-    out |= _backlight_mask;
+  out |= _idlePins();
 
   if (value & 0x01) out |= _data_mask[0];
   if (value & 0x02) out |= _data_mask[1];
@@ -408,13 +973,20 @@ void LiquidCrystal_PCF8574::_sendNibble(uint8_t value, bool isData)
   // pulse enable
   Wire.write(out | _enable_mask);
   Wire.write(out);
-  Wire.endTransmission();
+  _endTransmission();
 } // _sendNibble
 
 
+/// Wait until the display has finished the last instruction.
+/// Returns the number of polls of the busy flag or -1 when the flag could not be read
+/// (a failed transmission or request) or did not clear within LCD_BUSY_TIMEOUT.
 int LiquidCrystal_PCF8574::waitBusy() {
   int n = 0;
 
+  // The backpack waits for the display
+  if (_serial)
+    return 0;
+
   // Return after an appropriate waiting time if we cannot read 
   if (_rw_mask == 0) {
     delayMicroseconds(1500);
@@ -423,21 +995,31 @@ int LiquidCrystal_PCF8574::waitBusy() {
 
   // Set data pins as input (all HIGH)
   uint8_t out = _rw_mask | _data_mask[0] | _data_mask[1] | _data_mask[2] | _data_mask[3];
-  if (_backlight > 0)
-    out |= _backlight_mask;
+  out |= _idlePins();
 
   Wire.beginTransmission(_i2cAddr);
   // We change the RW pin. This may not be done together with ENABLE.
   Wire.write(out);
 
   uint8_t busy;
+  unsigned long start = micros();
   do {
     // read high nibble of input
     Wire.write(out | _enable_mask);
-    Wire.endTransmission();
-
-    Wire.requestFrom(_i2cAddr, uint8_t(1));
-    busy = Wire.read() & _data_mask[3];
+    uint8_t result = _endTransmission();
+
+    // E did not rise, no answer or no end of the busy state: give up instead of blocking
+    if ((result != 0) || (Wire.requestFrom(_i2cAddr, uint8_t(1)) != 1) || (micros() - start > LCD_BUSY_TIMEOUT)) {
+      if (_error == 0)
+        _error = LCD_ERROR_BUSY;
+      n = -1;
+      busy = 0;
+    } else {
+      uint8_t in = Wire.read();
+      _sample(in);
+      busy = in & _data_mask[3];
+      n++;
+    }
 
     Wire.beginTransmission(_i2cAddr);
     Wire.write(out);
@@ -445,30 +1027,279 @@ int LiquidCrystal_PCF8574::waitBusy() {
     // discard low nibble of input
     Wire.write(out | _enable_mask);
     Wire.write(out);
-
-    n++;
   } while (busy);
 
   // Reset RW bit
   out = 0x00;
-  if (_backlight > 0)
-    out |= _backlight_mask;
+  out |= _idlePins();
   Wire.write(out);
-  Wire.endTransmission();
+  _endTransmission();
+
+  // RS was set to LOW for reading the busy flag.
+  _rs_state = false;
 
   return n;
 }
 
 
+// Read the busy flag and the address counter. Returns -1 when the display does not answer.
+int LiquidCrystal_PCF8574::_readStatus()
+{
+  int status = 0;
+
+  // Set data pins as input (all HIGH)
+  uint8_t out = _rw_mask | _data_mask[0] | _data_mask[1] | _data_mask[2] | _data_mask[3];
+  out |= _idlePins();
+
+  Wire.beginTransmission(_i2cAddr);
+  // We change the RW pin. This may not be done together with ENABLE.
+  Wire.write(out);
+
+  for (uint8_t nibble = 0; nibble < 2; nibble++) {
+    Wire.write(out | _enable_mask);
+    _endTransmission();
+
+    if (Wire.requestFrom(_i2cAddr, uint8_t(1)) != 1) {
+      status = -1;
+    } else if (status >= 0) {
+      uint8_t in = Wire.read();
+      _sample(in);
+      status <<= 4;
+      if (in & _data_mask[0]) status |= 0x01;
+      if (in & _data_mask[1]) status |= 0x02;
+      if (in & _data_mask[2]) status |= 0x04;
+      if (in & _data_mask[3]) status |= 0x08;
+    }
+
+    Wire.beginTransmission(_i2cAddr);
+    Wire.write(out);
+  }
+
+  // Reset RW bit
+  out = 0x00;
+  out |= _idlePins();
+  Wire.write(out);
+  _endTransmission();
+
+  // RS was set to LOW for reading the status.
+  _rs_state = false;
+
+  return status;
+} // _readStatus()
+
+
+// Debounce the button pins of a byte read from the PCF8574.
+// A level is taken when it was read again after LCD_BUTTON_DEBOUNCE msec.
+void LiquidCrystal_PCF8574::_sample(uint8_t in)
+{
+  if (_input_mask == 0)
+    return;
+
+  unsigned long now = millis();
+  in &= _input_mask;
+  _sampleTime = now;
+
+  if (in != _raw) {
+    _raw = in;
+    _rawTime = now;
+
+  } else if ((in != _stable) && (now - _rawTime >= LCD_BUTTON_DEBOUNCE)) {
+    // a button is pressed when its pin is LOW
+    _pressed |= _stable & ~in;
+    _released |= ~_stable & in;
+    _stable = in;
+  }
+} // _sample()
+
+
+// keep track of the state of the display for an instruction
+void LiquidCrystal_PCF8574::_track(uint8_t value)
+{
+  if (value & 0x80) {
+    // Set DDRAM address
+    _addr = value & 0x7F;
+
+  } else if (value & 0x40) {
+    // Set CGRAM address, following data goes to the CGRAM
+    _addr = LCD_ADDR_UNKNOWN;
+
+  } else if (value & 0x20) {
+    // Function set
+
+  } else if (value & 0x10) {
+    // Cursor or display shift
+    if (value & 0x08)
+      _shiftDisplay(!(value & 0x04));
+    else
+      _step(value & 0x04);
+
+  } else if (value & 0x08) {
+    _displaycontrol = value & 0x07;
+
+  } else if (value & 0x04) {
+    _entrymode = value & 0x03;
+
+  } else if (value & 0x03) {
+    // Clear display also sets increment mode, Return home
+    if (value == 0x01)
+      _entrymode |= 0x02;
+    _addr = 0;
+    _shift = 0;
+  }
+} // _track()
+
+
+// keep track of the address counter and display shift after a character was written
+void LiquidCrystal_PCF8574::_advance()
+{
+  if (_addr == LCD_ADDR_UNKNOWN)
+    return;
+  bool increment = (_entrymode & 0x02);
+  _step(increment);
+  if (_entrymode & 0x01)
+    _shiftDisplay(increment);
+} // _advance()
+
+
+// move the tracked address counter like the display does
+void LiquidCrystal_PCF8574::_step(bool increment)
+{
+  if (_addr == LCD_ADDR_UNKNOWN)
+    return;
+
+  if (_lines > 1) {
+    // two lines: 0x00-0x27 and 0x40-0x67
+    if (increment) {
+      _addr++;
+      if (_addr == 0x28) _addr = 0x40;
+      else if (_addr == 0x68) _addr = 0x00;
+    } else {
+      if (_addr == 0x00) _addr = 0x67;
+      else if (_addr == 0x40) _addr = 0x27;
+      else _addr--;
+    }
+  } else {
+    // one line: 0x00-0x4F
+    if (increment)
+      _addr = (_addr >= 0x4F) ? 0 : _addr + 1;
+    else
+      _addr = (_addr == 0) ? 0x4F : _addr - 1;
+  }
+} // _step()
+
+
+void LiquidCrystal_PCF8574::_shiftDisplay(bool left)
+{
+  uint8_t lineLen = (_lines > 1) ? 40 : 80;
+  if (left)
+    _shift = (_shift + 1) % lineLen;
+  else
+    _shift = (_shift + lineLen - 1) % lineLen;
+} // _shiftDisplay()
+
+
+// the display RAM address of a position when the display is shifted by offset
+uint8_t LiquidCrystal_PCF8574::_address(uint8_t offset, uint8_t col, uint8_t row)
+{
+  uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54};
+
+  if (_lines <= 1)
+    return (col + offset) % 80;
+  uint8_t base = row_offsets[row & 0x03];
+  return (base & 0x40) | (((base & 0x3F) + col + offset) % 40);
+} // _address()
+
+
+// the distance of the pages in the display RAM
+uint8_t LiquidCrystal_PCF8574::_pageOffset()
+{
+  return (_lines > 1) ? 20 : 40;
+} // _pageOffset()
+
+
+// end a transmission and keep the first error
+uint8_t LiquidCrystal_PCF8574::_endTransmission()
+{
+  uint8_t result = Wire.endTransmission();
+  if (result != 0) {
+    if (_error == 0)
+      _error = result;
+    // the display may have missed instructions or data
+    _addr = LCD_ADDR_UNKNOWN;
+  } else {
+    // the spare pins are part of every transmission
+    _sparePending = false;
+  }
+  return result;
+} // _endTransmission()
+
+
+/// Return and reset the first error of the Wire transmissions since the last call.
+/// The values are the ones of Wire.endTransmission() and LCD_ERROR_BUSY.
+/// A display that has missed data should be initialized again by begin().
+uint8_t LiquidCrystal_PCF8574::lastError()
+{
+  uint8_t e = _error;
+  _error = 0;
+  return e;
+} // lastError()
+
+
+// wait for a group of displays: one fixed waiting time for all displays without rw,
+// after that the displays with rw are polled.
+void LiquidCrystal_PCF8574::_waitBusy(LiquidCrystal_PCF8574 *displays[], uint8_t count)
+{
+  uint8_t n;
+  for (n = 0; n < count; n++) {
+    if ((displays[n]->_rw_mask == 0) && !displays[n]->_serial) {
+      delayMicroseconds(1500);
+      break;
+    }
+  }
+  for (n = 0; n < count; n++) {
+    if (displays[n]->_rw_mask != 0)
+      displays[n]->waitBusy();
+  }
+} // _waitBusy()
+
+
 // private function to change the PCF8674 pins to the given value
 void LiquidCrystal_PCF8574::_write2Wire(uint8_t byte)
 {
-  uint8_t out = _rs_mask;
-  if (_backlight > 0)
-    out |= _backlight_mask;
+  if (_serial)
+    return;
+
+  // keep the RS line where it is, _rs_state must stay in sync with the pin.
+  uint8_t out = _rs_state ? _rs_mask : 0;
+  out |= _idlePins();
   Wire.beginTransmission(_i2cAddr);
   Wire.write(out);
-  Wire.endTransmission();
+  _endTransmission();
 } // write2Wire
 
+
+// Send characters to a SerLCD backpack in runs.
+// Custom characters need a setting command, '|' and 0xFE start commands and cannot be shown.
+void LiquidCrystal_PCF8574::_writeSerial(const uint8_t *buffer, size_t size)
+{
+  size_t start = 0;
+
+  for (size_t i = 0; i < size; i++) {
+    uint8_t c = buffer[i];
+    if ((c < 8) || (c == LCD_SERLCD_SETTING) || (c == LCD_SERLCD_COMMAND)) {
+      if (i > start)
+        _serial->write(buffer + start, i - start);
+      if (c < 8) {
+        uint8_t setting[2] = { LCD_SERLCD_SETTING, (uint8_t)(LCD_SERLCD_CHAR + c) };
+        _serial->write(setting, 2);
+      } else {
+        _serial->write(' ');
+      }
+      start = i + 1;
+    }
+  }
+  if (size > start)
+    _serial->write(buffer + start, size - start);
+} // _writeSerial()
+
 // The End.
@@ -26,15 +26,40 @@
 /// *   Replace int parameters by uint8_t where applicable
 /// *   Add variant createCharPgm() which retrieves data from PROGMEM
 /// *   clear() and home() wait for the display's busy signal (if rw is available)
+/// * 18.10.2026 pumpFrom() forwards the available bytes of a Stream in chunks.
+/// * 18.10.2026 createChar() is available on all architectures, not only on AVR.
+/// * 18.10.2026 Track address counter, entry mode and display shift. writeAt() writes to visible positions.
+/// * 18.10.2026 Pages in the hidden display RAM with a synchronized switch for groups of displays.
+/// * 18.10.2026 waitBusy() is bounded by a timeout, Wire errors are available by lastError().
+/// * 18.10.2026 begin() and clear() for groups of displays with common waiting times.
+/// * 18.10.2026 Keep _rs_state in sync after setBacklight() and waitBusy().
+/// * 18.10.2026 createChar() sends the bitmap in one run, preloadChar() keeps the cursor position.
+/// * 18.10.2026 beginWarm() keeps the content of a display that stayed powered.
+/// * 18.10.2026 Pins that are not connected to the display can be used as outputs.
+/// * 18.10.2026 Buttons on spare pins are sampled by the reads of the busy flag.
+/// * 18.10.2026 moveCursorLeft() and moveCursorRight() with the cursor shift instruction, cols() and rows().
+/// * 18.10.2026 SerLCD compatible backpacks on a serial port.
+/// * 18.10.2026 The group showPage() interleaves the shift instructions of the displays.
+/// * 18.10.2026 createChar() writes the bitmap in increment mode, also after rightToLeft() and autoscroll().
+/// * 18.10.2026 waitBusy() stops when the transmission for a read of the busy flag fails.
+/// * 18.10.2026 LCD_CHARS_PER_TRANSMISSION is available for the buffers of the other classes.
+/// * 18.10.2026 The group showPage() packs the shift instructions of a display into transmissions.
 
 #ifndef LiquidCrystal_PCF8574_h
 #define LiquidCrystal_PCF8574_h
 
 #include "Arduino.h"
 #include "Print.h"
+#include "Stream.h"
+#include <Wire.h>
 #include <stddef.h>
 #include <stdint.h>
 
+/// Characters that write() sends in one Wire transmission, every character takes 4 bytes on the bus.
+#define LCD_CHARS_PER_TRANSMISSION ((BUFFER_LENGTH - 4) / 4)
+
+#define LCD_ERROR_BUSY 0xFF ///< lastError(): the busy flag could not be read or did not clear
+
 enum LiquidCrystal_PCF8574_type {
     LiquidCrystal_PCF8574_Default, LiquidCrystal_PCF8574_JOY_IT
 };
@@ -48,6 +73,9 @@ public:
   // There is no sda and scl parameter for i2c in any api.
   // The Wire library has standard settings that can be overwritten by using Wire.begin(int sda, int scl) before calling LiquidCrystal_PCF8574::begin();
 
+  // SerLCD compatible backpack on a serial port
+  LiquidCrystal_PCF8574(Print &serial);
+
   // Choose pin assignments from a list of known modules
   LiquidCrystal_PCF8574(uint8_t i2cAddr, enum LiquidCrystal_PCF8574_type type);
 
@@ -60,8 +88,15 @@ public:
   // Functions from reference:
 
   void begin(uint8_t cols, uint8_t rows);
+  uint8_t cols() { return _cols; }
+  uint8_t rows() { return _lines; }
+  static void begin(LiquidCrystal_PCF8574 *displays[], uint8_t count, uint8_t cols, uint8_t rows);
+
+  // keep the content of a display that stayed powered, otherwise like begin()
+  bool beginWarm(uint8_t cols, uint8_t rows);
 
   void clear();
+  static void clear(LiquidCrystal_PCF8574 *displays[], uint8_t count);
   void home();
   void setCursor(uint8_t col, uint8_t row);
   void cursor();
@@ -72,12 +107,17 @@ public:
   void noDisplay();
   void scrollDisplayLeft();
   void scrollDisplayRight();
+  void moveCursorLeft();
+  void moveCursorRight();
   void autoscroll();
   void noAutoscroll();
   void leftToRight();
   void rightToLeft();
   void createChar(uint8_t, byte[]);
 
+  // define a character and restore the cursor position afterwards (when it is known)
+  void preloadChar(uint8_t location, byte charmap[]);
+
 #ifdef __AVR__
   // own additions
   void createCharPgm(uint8_t, const byte *);
@@ -90,20 +130,51 @@ public:
   void setBacklight(uint8_t brightness);
   inline void command(uint8_t value) { _send(value); }
 
+  // pins of the PCF8574 that are not connected to the display
+  uint8_t sparePins() { return _spare_mask; }
+  void setSparePin(uint8_t pin, bool value, bool defer = false);
+  void flushSparePins();
+
+  // buttons on spare pins, sampled by the reads of the busy flag
+  void setButtonPins(uint8_t pins);
+  uint8_t pollButtons();
+  uint8_t buttons() { return _input_mask & ~_stable; }
+  uint8_t buttonPresses();
+  uint8_t buttonReleases();
+
   // support of Print class
   virtual size_t write(uint8_t ch);
   virtual size_t write(const uint8_t *buffer, size_t size);
 
+  // write characters to a visible position, independent of entry mode and display shift
+  size_t writeAt(uint8_t col, uint8_t row, const uint8_t *buffer, size_t size);
+
+  // pages in the hidden part of the display RAM
+  uint8_t pageCount();
+  uint8_t visiblePage();
+  size_t writePage(uint8_t page, uint8_t col, uint8_t row, const uint8_t *buffer, size_t size);
+  void showPage(uint8_t page);
+  static void showPage(LiquidCrystal_PCF8574 *displays[], uint8_t count, uint8_t page);
+
+  // forward available bytes from a stream without blocking, optionally mapping '\n' to the next row
+  size_t pumpFrom(Stream &stream, size_t maxBytes, bool lineHandling = false);
+
   // helper functions
   int waitBusy();
+  uint8_t lastError();
 
 private:
   // instance variables
   uint8_t _i2cAddr; ///< Wire Address of the LCD
+  Print *_serial; ///< serial port of a SerLCD backpack instead of the PCF8574
   uint8_t _backlight; ///< the backlight intensity
+  uint8_t _cols; ///< number of columns of the display
   uint8_t _lines; ///< number of lines of the display
+  uint8_t _row; ///< row of the last setCursor() for line handling
   uint8_t _entrymode; ///<flags from entrymode
   uint8_t _displaycontrol; ///<flags from displaycontrol
+  uint8_t _addr; ///< DDRAM address counter of the display, 0xFF when unknown
+  uint8_t _shift; ///< number of positions the display is shifted to the left
 
   // variables on how the PCF8574 is connected to the LCD
   uint8_t _rs_mask;
@@ -112,14 +183,46 @@ private:
   uint8_t _backlight_mask;
   // these are used for 4-bit data to the display.
   uint8_t _data_mask[4];
+  uint8_t _spare_mask; ///< pins that are not connected to the display
+
+  uint8_t _spare; ///< state of the spare pins
+  bool _sparePending; ///< the spare pins have changed since the last transmission
+
+  uint8_t _input_mask; ///< spare pins with buttons
+  uint8_t _raw; ///< last level of the button pins
+  uint8_t _stable; ///< debounced level of the button pins
+  uint8_t _pressed; ///< buttons pressed since buttonPresses()
+  uint8_t _released; ///< buttons released since buttonReleases()
+  unsigned long _rawTime; ///< time of the last change of _raw
+  unsigned long _sampleTime; ///< time of the last read
 
   // state of the RS line
   bool _rs_state;
 
+  uint8_t _error; ///< first error of a Wire transmission
+
   // low level functions
   void _send(uint8_t value, bool isData = false);
   void _sendNibble(uint8_t halfByte, bool isData = false);
+  void _sendRepeated(uint8_t value, uint8_t count);
   void _write2Wire(uint8_t byte);
+  void _writeSerial(const uint8_t *buffer, size_t size);
+  uint8_t _endTransmission();
+  int _readStatus();
+  void _sample(uint8_t in);
+  // pins that keep their level during a transfer: backlight and spare pins
+  inline uint8_t _idlePins() { return _spare | ((_backlight > 0) ? _backlight_mask : 0); }
+  static void _waitBusy(LiquidCrystal_PCF8574 *displays[], uint8_t count);
+
+  // tracking of the display state
+  void _track(uint8_t value);
+  void _advance();
+  void _step(bool increment);
+  void _shiftDisplay(bool left);
+  uint8_t _address(uint8_t offset, uint8_t col, uint8_t row);
+  uint8_t _pageOffset();
+  size_t _writeAt(uint8_t offset, uint8_t col, uint8_t row, const uint8_t *buffer, size_t size);
+  uint8_t _pageShift(uint8_t page, uint8_t *instruction);
 
   void init(uint8_t i2cAddr, uint8_t rs, uint8_t rw, uint8_t enable,
     uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7, uint8_t backlight=255);
@@ -0,0 +1,191 @@
+/// \file LiquidCrystal_PCF8574_Editor.cpp
+/// \brief Line editor for text entry on a LiquidCrystal_PCF8574 display.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+/// \copyright Copyright (c) 2019 by Matthias Hertel.
+///
+/// ChangeLog see: LiquidCrystal_PCF8574_Editor.h
+
+#include "LiquidCrystal_PCF8574_Editor.h"
+
+LiquidCrystal_PCF8574_Editor::LiquidCrystal_PCF8574_Editor(LiquidCrystal_PCF8574 &lcd, char *text, uint8_t size,
+    uint8_t col, uint8_t row, uint8_t width)
+    : _lcd(lcd)
+{
+  _text = text;
+  _size = size;
+  _col = col;
+  _row = row;
+  _width = (width > 0) ? width : 1;
+  _max = 0;
+  _len = 0;
+  _pos = 0;
+  _first = 0;
+  _ac = LCD_EDITOR_UNKNOWN;
+  _panning = false;
+} // LiquidCrystal_PCF8574_Editor
+
+
+void LiquidCrystal_PCF8574_Editor::begin()
+{
+  uint8_t lineLen = (_lcd.rows() <= 1) ? 80 : 40; // length of a display RAM line
+  uint8_t room;
+
+  // with more than 2 lines a display RAM line holds 2 rows and the display shift cannot be used.
+  // The text continues in the display RAM after the field, so only a field at the right edge can pan.
+  _panning = (_lcd.rows() <= 2) && (_col + _width >= _lcd.cols()) && (_col < lineLen);
+  room = _panning ? (lineLen - _col - 1) : (_width - 1);
+  _max = (_size - 1 < room) ? _size - 1 : room;
+
+  _len = strlen(_text);
+  if (_len > _max) {
+    _len = _max;
+    _text[_len] = '\0';
+  }
+  _pos = _len;
+
+  // start without display shift, the cursor moves to the right
+  _lcd.showPage(0);
+  _lcd.leftToRight();
+  _first = 0;
+  _send(0, (_len > _width) ? _len : _width);
+  _update();
+  _lcd.cursor();
+} // begin()
+
+
+void LiquidCrystal_PCF8574_Editor::end()
+{
+  _lcd.noCursor();
+  _lcd.showPage(0);
+  _first = 0;
+  _ac = LCD_EDITOR_UNKNOWN;
+} // end()
+
+
+bool LiquidCrystal_PCF8574_Editor::insert(char c)
+{
+  if (_len >= _max)
+    return false;
+
+  memmove(_text + _pos + 1, _text + _pos, _len - _pos + 1);
+  _text[_pos] = c;
+  _len++;
+
+  // rewrite the tail, at the end of the text this is only the new character
+  _send(_pos, _len - _pos);
+  _pos++;
+  _update();
+  return true;
+} // insert()
+
+
+bool LiquidCrystal_PCF8574_Editor::backspace()
+{
+  if (_pos == 0)
+    return false;
+  _pos--;
+  return remove();
+} // backspace()
+
+
+bool LiquidCrystal_PCF8574_Editor::remove()
+{
+  if (_pos >= _len)
+    return false;
+
+  memmove(_text + _pos, _text + _pos + 1, _len - _pos);
+  _len--;
+
+  // rewrite the tail and clear the last character
+  _send(_pos, _len - _pos + 1);
+  _update();
+  return true;
+} // remove()
+
+
+bool LiquidCrystal_PCF8574_Editor::left()
+{
+  if (_pos == 0)
+    return false;
+  _pos--;
+  _update();
+  return true;
+} // left()
+
+
+bool LiquidCrystal_PCF8574_Editor::right()
+{
+  if (_pos >= _len)
+    return false;
+  _pos++;
+  _update();
+  return true;
+} // right()
+
+
+/// Move the cursor to a position. This also brings the cursor back after other parts of the display were written.
+void LiquidCrystal_PCF8574_Editor::moveTo(uint8_t pos)
+{
+  _pos = (pos < _len) ? pos : _len;
+  _ac = LCD_EDITOR_UNKNOWN;
+  _update();
+} // moveTo()
+
+
+/// Write count characters of the text starting at position from, positions after the end of the text are cleared.
+void LiquidCrystal_PCF8574_Editor::_send(uint8_t from, uint8_t count)
+{
+  uint8_t blanks[LCD_CHARS_PER_TRANSMISSION];
+  uint8_t n = 0;
+
+  if (from < _len)
+    n = (count < _len - from) ? count : _len - from;
+  if (n > 0)
+    _lcd.writePage(0, _col + from, _row, (const uint8_t *)_text + from, n);
+  from += n;
+  count -= n;
+
+  if (count > 0)
+    memset(blanks, ' ', sizeof(blanks));
+  while (count > 0) {
+    n = (count < sizeof(blanks)) ? count : sizeof(blanks);
+    _lcd.writePage(0, _col + from, _row, blanks, n);
+    from += n;
+    count -= n;
+  }
+  _ac = from;
+} // _send()
+
+
+/// Pan the text so the edit position is visible and move the cursor to the edit position.
+void LiquidCrystal_PCF8574_Editor::_update()
+{
+  if (_panning) {
+    uint8_t first = _first;
+
+    if (_pos < first)
+      first = _pos;
+    else if (_pos >= first + _width)
+      first = _pos - _width + 1;
+    // do not leave free space in the field when the text has become shorter
+    if (first + _width > _len + 1)
+      first = (_len + 1 > _width) ? _len + 1 - _width : 0;
+
+    for (; _first < first; _first++)
+      _lcd.scrollDisplayLeft();
+    for (; _first > first; _first--)
+      _lcd.scrollDisplayRight();
+  }
+
+  if (_ac == _pos + 1) {
+    _lcd.moveCursorLeft();
+  } else if (_ac + 1 == _pos) {
+    _lcd.moveCursorRight();
+  } else if (_ac != _pos) {
+    _lcd.setCursor(_col + _pos, _row);
+  }
+  _ac = _pos;
+} // _update()
+
+// The End.
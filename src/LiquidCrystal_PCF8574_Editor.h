@@ -0,0 +1,91 @@
+/// \file LiquidCrystal_PCF8574_Editor.h
+/// \brief Line editor for text entry on a LiquidCrystal_PCF8574 display.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+///
+/// \copyright Copyright (c) 2019 by Matthias Hertel.\n
+///
+/// The library work is licensed under a BSD style license.\n
+/// See http://www.mathertel.de/License.aspx
+///
+/// \details
+/// The editor works on a text buffer of the application and shows it in a field of one row with the cursor at the edit position.
+/// It keeps track of the text on the display so an edit only costs a few instructions:
+/// * moving the cursor by one position is a single cursor shift instruction,
+/// * inserting or deleting a character rewrites only the characters from the edit position to the end of the text,
+/// * typing at the end of the text sends only the new character.
+///
+/// On displays with up to 2 lines and a field that ends at the right edge of the display the text is kept in the
+/// complete display RAM line and texts longer than the field are panned with the display shift instead of rewriting
+/// the field. The display shift moves all rows, so other content on the display moves with the text.
+/// Otherwise the text is limited to the width of the field and the characters after the field are not changed.
+/// The editor uses the left to right entry mode.
+///
+/// Example:
+///   char name[24] = "";
+///   LiquidCrystal_PCF8574_Editor editor(lcd, name, sizeof(name), 6, 0, 10);
+///   lcd.print("Name:");
+///   editor.begin();
+///   editor.insert('A');
+///
+/// ChangeLog:
+/// --------
+/// * 18.10.2026 created.
+/// * 18.10.2026 blanks are sent in chunks of one Wire transmission.
+
+#ifndef LiquidCrystal_PCF8574_Editor_h
+#define LiquidCrystal_PCF8574_Editor_h
+
+#include "LiquidCrystal_PCF8574.h"
+
+#define LCD_EDITOR_UNKNOWN 0xFF ///< position of the address counter is not known
+
+class LiquidCrystal_PCF8574_Editor
+{
+public:
+  LiquidCrystal_PCF8574_Editor(LiquidCrystal_PCF8574 &lcd, char *text, uint8_t size,
+    uint8_t col, uint8_t row, uint8_t width);
+
+  // show the text and the cursor at the end of the text. The display must be initialized by begin() before.
+  void begin();
+
+  // hide the cursor and shift the display back.
+  void end();
+
+  // insert a character at the cursor. Returns false when the text is full.
+  bool insert(char c);
+
+  // delete the character before the cursor.
+  bool backspace();
+
+  // delete the character at the cursor.
+  bool remove();
+
+  bool left();
+  bool right();
+  void moveTo(uint8_t pos);
+
+  const char *text() { return _text; }
+  uint8_t length() { return _len; }
+  uint8_t position() { return _pos; }
+
+private:
+  LiquidCrystal_PCF8574 &_lcd;
+  char *_text;
+  uint8_t _size;
+  uint8_t _col;
+  uint8_t _row;
+  uint8_t _width;
+
+  uint8_t _max; ///< maximum length of the text
+  uint8_t _len; ///< length of the text
+  uint8_t _pos; ///< edit position
+  uint8_t _first; ///< first visible position, the display shift when panning
+  uint8_t _ac; ///< position of the address counter of the display
+  bool _panning; ///< the display shift is used
+
+  void _send(uint8_t from, uint8_t count);
+  void _update();
+};
+
+#endif
@@ -0,0 +1,95 @@
+/// \file LiquidCrystal_PCF8574_Exchange.cpp
+/// \brief Triple buffered exchange of screen frames between an application task and a render task.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+/// \copyright Copyright (c) 2019 by Matthias Hertel.
+///
+/// ChangeLog see: LiquidCrystal_PCF8574_Exchange.h
+
+#include "LiquidCrystal_PCF8574_Exchange.h"
+
+#if !defined(__AVR__)
+
+#define LCD_EXCHANGE_NEW 0x80 ///< flag in _middle: the frame was not taken by the consumer
+#define LCD_EXCHANGE_SENT 3 ///< index of the frame on the display
+
+LiquidCrystal_PCF8574_Exchange::LiquidCrystal_PCF8574_Exchange(LiquidCrystal_PCF8574 &lcd, uint8_t cols, uint8_t rows, uint8_t *buffer)
+    : _lcd(lcd)
+{
+  _cols = cols;
+  _rows = rows;
+  _buffer = buffer;
+  memset(_buffer, ' ', LCD_EXCHANGE_SIZE(cols, rows));
+  _back = 0;
+  _middle = 1;
+  _front = 2;
+  _valid = false;
+} // LiquidCrystal_PCF8574_Exchange
+
+
+/// Swap the drawn frame with the one in the exchange.
+/// The consumer never writes to the published frame, so it can be copied afterwards.
+void LiquidCrystal_PCF8574_Exchange::publish()
+{
+  uint8_t done = _back;
+  _back = _middle.exchange(done | LCD_EXCHANGE_NEW, std::memory_order_acq_rel) & ~LCD_EXCHANGE_NEW;
+  memcpy(_frame(_back), _frame(done), _cols * _rows);
+} // publish()
+
+
+bool LiquidCrystal_PCF8574_Exchange::flush()
+{
+  if (!(_middle.load(std::memory_order_acquire) & LCD_EXCHANGE_NEW))
+    return false;
+
+  // only the consumer clears the flag so the frame in the exchange is new
+  _front = _middle.exchange(_front, std::memory_order_acq_rel) & ~LCD_EXCHANGE_NEW;
+
+  const uint8_t *text = _frame(_front);
+  uint8_t *sent = _frame(LCD_EXCHANGE_SENT);
+  if (!_valid) {
+    // force all characters to be sent
+    for (uint16_t i = 0; i < _cols * _rows; i++)
+      sent[i] = ~text[i];
+    _valid = true;
+  }
+  for (uint8_t r = 0; r < _rows; r++)
+    _sendRow(r, text + r * _cols, sent + r * _cols);
+  return true;
+} // flush()
+
+
+void LiquidCrystal_PCF8574_Exchange::invalidate()
+{
+  _valid = false;
+} // invalidate()
+
+
+/// Send the characters of a row that differ from the sent frame.
+/// A gap of a single unchanged character is sent with the run to save the address instruction.
+void LiquidCrystal_PCF8574_Exchange::_sendRow(uint8_t row, const uint8_t *text, uint8_t *sent)
+{
+  uint8_t i = 0;
+
+  while (i < _cols) {
+    if (text[i] == sent[i]) {
+      i++;
+      continue;
+    }
+    uint8_t start = i;
+    uint8_t end = i;
+    while (i < _cols) {
+      if (text[i] != sent[i])
+        end = i;
+      else if (i - end > 1)
+        break;
+      i++;
+    }
+    _lcd.writeAt(start, row, text + start, end - start + 1);
+    memcpy(sent + start, text + start, end - start + 1);
+  }
+} // _sendRow()
+
+#endif
+
+// The End.
@@ -0,0 +1,72 @@
+/// \file LiquidCrystal_PCF8574_Exchange.h
+/// \brief Triple buffered exchange of screen frames between an application task and a render task.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+///
+/// \copyright Copyright (c) 2019 by Matthias Hertel.\n
+///
+/// The library work is licensed under a BSD style license.\n
+/// See http://www.mathertel.de/License.aspx
+///
+/// \details
+/// A frame is the content of the display, cols * rows characters row by row.
+/// The producer (the application task) draws into frame() and hands it over with publish().
+/// It always gets a free buffer and never waits for the display.
+/// The consumer (the render task, e.g. on the other core of an ESP32) calls flush() that sends the newest published frame
+/// by comparing it with the frame that was sent last. Frames published in the meantime are dropped.
+///
+/// The buffers are exchanged by an atomic index so no lock is held while the bus is used.
+/// Only one producer task and one consumer task may use an exchange.
+/// The class uses std::atomic and is not available on AVR.
+///
+/// The buffer given to the constructor must have LCD_EXCHANGE_SIZE(cols, rows) bytes:
+/// three frames for the exchange and the frame on the display.
+///
+/// ChangeLog:
+/// --------
+/// * 18.10.2026 created.
+
+#ifndef LiquidCrystal_PCF8574_Exchange_h
+#define LiquidCrystal_PCF8574_Exchange_h
+
+#if !defined(__AVR__)
+
+#include <atomic>
+#include "LiquidCrystal_PCF8574.h"
+
+#define LCD_EXCHANGE_SIZE(cols, rows) (4 * (cols) * (rows))
+
+class LiquidCrystal_PCF8574_Exchange
+{
+public:
+  LiquidCrystal_PCF8574_Exchange(LiquidCrystal_PCF8574 &lcd, uint8_t cols, uint8_t rows, uint8_t *buffer);
+
+  // producer: the frame to draw into. It keeps its content after publish().
+  uint8_t *frame() { return _frame(_back); }
+
+  // producer: hand the frame over to the render task.
+  void publish();
+
+  // consumer: send the newest published frame. Returns false when there was no new frame.
+  bool flush();
+
+  // consumer: send the complete frame with the next flush(), e.g. after begin() or clear().
+  void invalidate();
+
+private:
+  LiquidCrystal_PCF8574 &_lcd;
+  uint8_t _cols;
+  uint8_t _rows;
+  uint8_t *_buffer;
+
+  uint8_t _back; ///< frame of the producer
+  uint8_t _front; ///< frame of the consumer
+  std::atomic<uint8_t> _middle; ///< frame in the exchange and the flag for a new frame
+  bool _valid; ///< the sent frame matches the display
+
+  uint8_t *_frame(uint8_t index) { return _buffer + index * _cols * _rows; }
+  void _sendRow(uint8_t row, const uint8_t *text, uint8_t *sent);
+};
+
+#endif
+#endif
@@ -0,0 +1,152 @@
+/// \file LiquidCrystal_PCF8574_Glyphs.cpp
+/// \brief CGRAM slot management with preloading of the glyphs of the next screens.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+/// \copyright Copyright (c) 2019 by Matthias Hertel.
+///
+/// ChangeLog see: LiquidCrystal_PCF8574_Glyphs.h
+
+#include "LiquidCrystal_PCF8574_Glyphs.h"
+
+LiquidCrystal_PCF8574_Glyphs::LiquidCrystal_PCF8574_Glyphs(LiquidCrystal_PCF8574 &lcd, const uint8_t (*glyphs)[8], uint8_t glyphCount)
+    : _lcd(lcd)
+{
+  _glyphs = glyphs;
+  _glyphCount = glyphCount;
+  _hint = NULL;
+  _hintCount = 0;
+  reset();
+} // LiquidCrystal_PCF8574_Glyphs
+
+
+void LiquidCrystal_PCF8574_Glyphs::reset()
+{
+  for (uint8_t s = 0; s < LCD_GLYPH_SLOTS; s++)
+    _slot[s] = LCD_GLYPH_NONE;
+  _used = 0;
+} // reset()
+
+
+bool LiquidCrystal_PCF8574_Glyphs::use(const uint8_t *set, uint8_t count)
+{
+  uint8_t keep = 0;
+  bool ok = true;
+
+  // keep the slots of the glyphs that are already loaded
+  for (uint8_t n = 0; n < count; n++) {
+    uint8_t s = slot(set[n]);
+    if (s != LCD_GLYPH_NONE)
+      keep |= (1 << s);
+  }
+
+  // upload the missing glyphs, the slots of the previous screen are replaced last
+  for (uint8_t n = 0; n < count; n++) {
+    if ((set[n] >= _glyphCount) || (slot(set[n]) != LCD_GLYPH_NONE))
+      continue;
+    uint8_t s = _victim(keep, _used);
+    if (s == LCD_GLYPH_NONE) {
+      ok = false;
+      break;
+    }
+    _upload(s, set[n]);
+    keep |= (1 << s);
+  }
+
+  _used = keep;
+  return ok;
+} // use()
+
+
+uint8_t LiquidCrystal_PCF8574_Glyphs::slot(uint8_t glyph)
+{
+  for (uint8_t s = 0; s < LCD_GLYPH_SLOTS; s++) {
+    if (_slot[s] == glyph)
+      return s;
+  }
+  return LCD_GLYPH_NONE;
+} // slot()
+
+
+void LiquidCrystal_PCF8574_Glyphs::hint(const uint8_t *set, uint8_t count)
+{
+  _hint = set;
+  _hintCount = count;
+} // hint()
+
+
+bool LiquidCrystal_PCF8574_Glyphs::idle()
+{
+  uint8_t keep = _used;
+
+  for (uint8_t n = 0; n < _hintCount; n++) {
+    uint8_t glyph = _hint[n];
+    uint8_t s = slot(glyph);
+
+    if (s != LCD_GLYPH_NONE) {
+      // protect the more likely glyphs from being replaced by the less likely ones
+      keep |= (1 << s);
+
+    } else if (glyph < _glyphCount) {
+      // never replace a glyph that is hinted itself
+      s = _victim(keep, 0);
+      if ((s == LCD_GLYPH_NONE) || _hinted(_slot[s], _hintCount))
+        return false;
+      _upload(s, glyph);
+      return true;
+    }
+  }
+  return false;
+} // idle()
+
+
+// check whether a glyph is in the first count entries of the hint list.
+bool LiquidCrystal_PCF8574_Glyphs::_hinted(uint8_t glyph, uint8_t count)
+{
+  if (glyph == LCD_GLYPH_NONE)
+    return false;
+  for (uint8_t n = 0; n < count; n++) {
+    if (_hint[n] == glyph)
+      return true;
+  }
+  return false;
+} // _hinted()
+
+
+// find a slot for a new glyph: an empty slot first, then one with a glyph that is not hinted.
+// Slots in keep are never returned, slots in avoid only when there is no other.
+uint8_t LiquidCrystal_PCF8574_Glyphs::_victim(uint8_t keep, uint8_t avoid)
+{
+  uint8_t best = LCD_GLYPH_NONE;
+  uint8_t bestRank = 0;
+
+  for (uint8_t s = 0; s < LCD_GLYPH_SLOTS; s++) {
+    if (keep & (1 << s))
+      continue;
+
+    uint8_t rank;
+    if (_slot[s] == LCD_GLYPH_NONE)
+      rank = 4;
+    else if (!_hinted(_slot[s], _hintCount))
+      rank = 3;
+    else
+      rank = 2;
+    if (avoid & (1 << s))
+      rank -= 1;
+
+    if (rank > bestRank) {
+      best = s;
+      bestRank = rank;
+    }
+  }
+  return best;
+} // _victim()
+
+
+// the cursor position is kept so uploads can be done between writes of the application.
+void LiquidCrystal_PCF8574_Glyphs::_upload(uint8_t slot, uint8_t glyph)
+{
+  byte data[8];
+  memcpy_P(data, _glyphs[glyph], 8);
+  _lcd.preloadChar(slot, data);
+  _slot[slot] = glyph;
+} // _upload()
@@ -0,0 +1,79 @@
+/// \file LiquidCrystal_PCF8574_Glyphs.h
+/// \brief CGRAM slot management with preloading of the glyphs of the next screens.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+///
+/// \copyright Copyright (c) 2019 by Matthias Hertel.\n
+///
+/// The library work is licensed under a BSD style license.\n
+/// See http://www.mathertel.de/License.aspx
+///
+/// \details
+/// The application owns a table of glyph bitmaps (8 bytes each) in PROGMEM and refers to the glyphs by their index.
+/// Every screen declares the glyphs it shows by use(). The glyphs of the screen get a CGRAM slot,
+/// slot() returns the character code to print for a glyph.
+///
+/// With hint() the application declares the glyphs of the screens that are likely shown next,
+/// the most likely first. idle() uploads one of them into a slot that is not used by the current screen.
+/// When the next screen is switched by use() its glyphs are already in the display and
+/// the switch only needs the display RAM writes.
+///
+/// Example:
+///   const uint8_t glyphs[][8] PROGMEM = { { 0x04, 0x0E, ... }, ... };
+///   LiquidCrystal_PCF8574_Glyphs cgram(lcd, glyphs, 12);
+///   const uint8_t mainGlyphs[] = { 0, 1, 2 };
+///   const uint8_t setupGlyphs[] = { 3, 4 };
+///   cgram.use(mainGlyphs, 3);
+///   cgram.hint(setupGlyphs, 2);
+///   ...
+///   if (nothingElseToDo) cgram.idle();
+///
+/// ChangeLog:
+/// --------
+/// * 18.10.2026 created.
+
+#ifndef LiquidCrystal_PCF8574_Glyphs_h
+#define LiquidCrystal_PCF8574_Glyphs_h
+
+#include "LiquidCrystal_PCF8574.h"
+
+#define LCD_GLYPH_SLOTS 8
+#define LCD_GLYPH_NONE 0xFF ///< no glyph in a slot or no slot for a glyph
+
+class LiquidCrystal_PCF8574_Glyphs
+{
+public:
+  LiquidCrystal_PCF8574_Glyphs(LiquidCrystal_PCF8574 &lcd, const uint8_t (*glyphs)[8], uint8_t glyphCount);
+
+  // forget the content of the CGRAM, e.g. after begin().
+  void reset();
+
+  // make the glyphs of the current screen available, missing glyphs are uploaded now.
+  // Returns false when the glyphs do not fit into the CGRAM.
+  bool use(const uint8_t *set, uint8_t count);
+
+  // character code of a glyph or LCD_GLYPH_NONE when it is not in the CGRAM.
+  uint8_t slot(uint8_t glyph);
+
+  // glyphs of the likely next screens, the most likely first. The list is not copied.
+  void hint(const uint8_t *set, uint8_t count);
+
+  // upload one hinted glyph into a free slot. Returns true when the bus was used.
+  bool idle();
+
+private:
+  LiquidCrystal_PCF8574 &_lcd;
+  const uint8_t (*_glyphs)[8]; ///< glyph bitmaps in PROGMEM
+  uint8_t _glyphCount;
+
+  uint8_t _slot[LCD_GLYPH_SLOTS]; ///< glyph in every CGRAM slot
+  uint8_t _used; ///< slots used by the current screen
+  const uint8_t *_hint; ///< glyphs of the likely next screens
+  uint8_t _hintCount;
+
+  bool _hinted(uint8_t glyph, uint8_t count);
+  uint8_t _victim(uint8_t keep, uint8_t avoid);
+  void _upload(uint8_t slot, uint8_t glyph);
+};
+
+#endif
@@ -0,0 +1,249 @@
+/// \file LiquidCrystal_PCF8574_Menu.cpp
+/// \brief Menu with incremental redraw for LiquidCrystal_PCF8574 displays.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+/// \copyright Copyright (c) 2019 by Matthias Hertel.
+///
+/// ChangeLog see: LiquidCrystal_PCF8574_Menu.h
+
+#include "LiquidCrystal_PCF8574_Menu.h"
+
+LiquidCrystal_PCF8574_Menu::LiquidCrystal_PCF8574_Menu(LiquidCrystal_PCF8574 &lcd, const char *const *items, uint8_t itemCount,
+    uint8_t cols, uint8_t rows, char marker)
+    : _lcd(lcd)
+{
+  _items = items;
+  _itemCount = itemCount;
+  _cols = (cols > 40) ? 40 : cols;
+  _rows = (rows > LCD_MENU_MAXROWS) ? LCD_MENU_MAXROWS : rows;
+  _marker = marker;
+  _selected = 0;
+  _top = 0;
+  _page = 0;
+  _hiddenPage = LCD_MENU_NONE;
+  for (uint8_t r = 0; r < LCD_MENU_MAXROWS; r++) {
+    _rowItem[0][r] = LCD_MENU_NONE;
+    _rowItem[1][r] = LCD_MENU_UNKNOWN;
+  }
+  _markerRow[0] = _markerRow[1] = LCD_MENU_NONE;
+} // LiquidCrystal_PCF8574_Menu
+
+
+void LiquidCrystal_PCF8574_Menu::draw()
+{
+  uint8_t page = _lcd.visiblePage();
+
+  // the hidden page can only be used when the display shows one of the pages
+  _page = (page == 1) ? 1 : 0;
+  if ((page != 0xFF) && (_lcd.pageCount() > 1))
+    _hiddenPage = 1 - page;
+  else
+    _hiddenPage = LCD_MENU_NONE;
+
+  for (uint8_t r = 0; r < LCD_MENU_MAXROWS; r++)
+    _rowItem[0][r] = _rowItem[1][r] = LCD_MENU_UNKNOWN;
+  _markerRow[0] = _markerRow[1] = LCD_MENU_NONE;
+  _render(_page, _top, _selected, false);
+} // draw()
+
+
+void LiquidCrystal_PCF8574_Menu::next()
+{
+  if (_selected + 1 < _itemCount)
+    select(_selected + 1);
+} // next()
+
+
+void LiquidCrystal_PCF8574_Menu::prev()
+{
+  if (_selected > 0)
+    select(_selected - 1);
+} // prev()
+
+
+void LiquidCrystal_PCF8574_Menu::select(uint8_t item)
+{
+  if (item >= _itemCount)
+    return;
+  uint8_t top = _top;
+  _selected = item;
+
+  // scroll as little as possible to make the selection visible
+  if (_selected < _top)
+    _top = _selected;
+  else if (_selected >= _top + _rows)
+    _top = _selected - _rows + 1;
+
+  if ((_top != top) && (_hiddenPage != LCD_MENU_NONE) && _shows(_hiddenPage, _top, _selected)) {
+    // the prefetched view is right
+    _lcd.showPage(_hiddenPage);
+    _hiddenPage = _page;
+    _page = 1 - _page;
+  } else {
+    _render(_page, _top, _selected, false);
+  }
+} // select()
+
+
+/// Render the view of the next scroll step into the hidden page, one row per call.
+/// The direction is the one the selection is closer to.
+bool LiquidCrystal_PCF8574_Menu::prefetch()
+{
+  if (_hiddenPage == LCD_MENU_NONE)
+    return false;
+
+  bool forward = (2 * (_selected - _top) + 1 >= _rows);
+  if (forward ? (_top + _rows >= _itemCount) : (_top == 0))
+    forward = !forward;
+
+  if (forward) {
+    if (_top + _rows >= _itemCount)
+      return false;
+    return _render(_hiddenPage, _top + 1, _top + _rows, true);
+  }
+  if (_top == 0)
+    return false;
+  return _render(_hiddenPage, _top - 1, _top - 1, true);
+} // prefetch()
+
+
+const char *LiquidCrystal_PCF8574_Menu::_text(uint8_t item)
+{
+  if ((item == LCD_MENU_NONE) || (item == LCD_MENU_UNKNOWN))
+    return NULL;
+  return (const char *)pgm_read_ptr(_items + item);
+} // _text()
+
+
+uint8_t LiquidCrystal_PCF8574_Menu::_item(uint8_t top, uint8_t row)
+{
+  if (top + row >= _itemCount)
+    return LCD_MENU_NONE;
+  return top + row;
+} // _item()
+
+
+/// Check whether a page shows a view.
+bool LiquidCrystal_PCF8574_Menu::_shows(uint8_t page, uint8_t top, uint8_t selected)
+{
+  if (_markerRow[page] != selected - top)
+    return false;
+  for (uint8_t r = 0; r < _rows; r++) {
+    if (_rowItem[page][r] != _item(top, r))
+      return false;
+  }
+  return true;
+} // _shows()
+
+
+/// Send the differences between a page and a view.
+/// With step set only the first difference is sent.
+/// Returns true when something was sent.
+bool LiquidCrystal_PCF8574_Menu::_render(uint8_t page, uint8_t top, uint8_t selected, bool step)
+{
+  uint8_t markerRow = selected - top;
+  uint8_t *rowItem = _rowItem[page];
+  bool sent = false;
+
+  uint8_t old = _markerRow[page];
+  if ((old != markerRow) && (old < _rows) && (rowItem[old] != LCD_MENU_UNKNOWN)) {
+    _sendMarker(page, old, ' ');
+    _markerRow[page] = LCD_MENU_NONE;
+    if (step)
+      return true;
+    sent = true;
+  }
+
+  for (uint8_t r = 0; r < _rows; r++) {
+    uint8_t item = _item(top, r);
+    if (item != rowItem[r]) {
+      if (rowItem[r] == LCD_MENU_UNKNOWN) {
+        // the complete row is sent including the marker column
+        if (r == markerRow)
+          _markerRow[page] = markerRow;
+        else if (r == _markerRow[page])
+          _markerRow[page] = LCD_MENU_NONE;
+      }
+      _sendRow(page, r, item, (r == markerRow) ? _marker : ' ');
+      rowItem[r] = item;
+      if (step)
+        return true;
+      sent = true;
+    }
+  }
+
+  if (_markerRow[page] != markerRow) {
+    _sendMarker(page, markerRow, _marker);
+    _markerRow[page] = markerRow;
+    sent = true;
+  }
+  return sent;
+} // _render()
+
+
+/// Send the text of an item.
+/// When the row on the page is unknown the complete row including the marker column is sent,
+/// otherwise only the characters that differ from the item on the page.
+void LiquidCrystal_PCF8574_Menu::_sendRow(uint8_t page, uint8_t row, uint8_t item, char first)
+{
+  bool all = (_rowItem[page][row] == LCD_MENU_UNKNOWN);
+  const char *text = _text(item);
+  const char *old = _text(_rowItem[page][row]);
+  uint8_t buffer[40];
+  int8_t start = -1; // start of the current run
+  uint8_t end = 0;
+
+  if (all) {
+    buffer[0] = first;
+    start = 0;
+  }
+
+  for (uint8_t i = 1; i < _cols; i++) {
+    char c = ' ', o = ' ';
+    if (text) {
+      c = pgm_read_byte(text++);
+      if (c == '\0') {
+        c = ' ';
+        text = NULL;
+      }
+    }
+    if (old) {
+      o = pgm_read_byte(old++);
+      if (o == '\0') {
+        o = ' ';
+        old = NULL;
+      }
+    }
+    buffer[i] = c;
+
+    if (all || (c != o)) {
+      if (start < 0)
+        start = i;
+      end = i;
+    } else if ((start >= 0) && (i - end > 1)) {
+      // a gap of more than one unchanged character ends the run
+      _write(page, start, row, buffer + start, end - start + 1);
+      start = -1;
+    }
+  }
+  if (start >= 0) {
+    _write(page, start, row, buffer + start, end - start + 1);
+  }
+} // _sendRow()
+
+
+void LiquidCrystal_PCF8574_Menu::_sendMarker(uint8_t page, uint8_t row, char c)
+{
+  _write(page, 0, row, (const uint8_t *)&c, 1);
+} // _sendMarker()
+
+
+void LiquidCrystal_PCF8574_Menu::_write(uint8_t page, uint8_t col, uint8_t row, const uint8_t *buffer, uint8_t size)
+{
+  if (page == _page)
+    _lcd.writeAt(col, row, buffer, size);
+  else
+    _lcd.writePage(page, col, row, buffer, size);
+} // _write()
+
+// The End.
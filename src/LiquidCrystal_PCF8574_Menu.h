@@ -0,0 +1,87 @@
+/// \file LiquidCrystal_PCF8574_Menu.h
+/// \brief Menu with incremental redraw for LiquidCrystal_PCF8574 displays.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+///
+/// \copyright Copyright (c) 2019 by Matthias Hertel.\n
+///
+/// The library work is licensed under a BSD style license.\n
+/// See http://www.mathertel.de/License.aspx
+///
+/// \details
+/// The menu shows a list of items in the rows of the display with a marker in the first column
+/// in front of the selected item.
+/// The item texts are read from PROGMEM and the menu remembers which item is shown in every row.
+/// Moving the selection within the visible rows only rewrites the two marker cells,
+/// scrolling only rewrites the characters of the rows that differ.
+///
+/// On displays with a second display RAM page (up to 2 lines) prefetch() renders the view of the next scroll step
+/// into the hidden page while the application has nothing else to do. The direction is guessed from the position
+/// of the selection. When the menu scrolls to the prepared view only the page is switched, otherwise the hidden page
+/// is left as it is and the changes are written to the visible page.
+///
+/// Example:
+///   const char item0[] PROGMEM = "Settings";
+///   const char item1[] PROGMEM = "Information";
+///   const char *const items[] PROGMEM = { item0, item1 };
+///   LiquidCrystal_PCF8574_Menu menu(lcd, items, 2, 16, 2);
+///
+/// ChangeLog:
+/// --------
+/// * 18.10.2026 created.
+/// * 18.10.2026 prefetch() prepares the next view in the hidden display RAM page.
+
+#ifndef LiquidCrystal_PCF8574_Menu_h
+#define LiquidCrystal_PCF8574_Menu_h
+
+#include "LiquidCrystal_PCF8574.h"
+
+#define LCD_MENU_MAXROWS 4
+#define LCD_MENU_NONE 0xFF ///< no item in a row
+#define LCD_MENU_UNKNOWN 0xFE ///< content of a row is not known
+
+class LiquidCrystal_PCF8574_Menu
+{
+public:
+  LiquidCrystal_PCF8574_Menu(LiquidCrystal_PCF8574 &lcd, const char *const *items, uint8_t itemCount,
+    uint8_t cols, uint8_t rows, char marker = '>');
+
+  // send all rows of the menu.
+  void draw();
+
+  // move the selection and send the changes.
+  void next();
+  void prev();
+  void select(uint8_t item);
+
+  // render a part of the next view into the hidden page. Returns false when there was nothing to do.
+  bool prefetch();
+
+  uint8_t selected() { return _selected; }
+  uint8_t top() { return _top; }
+
+private:
+  LiquidCrystal_PCF8574 &_lcd;
+  const char *const *_items; ///< item texts in PROGMEM
+  uint8_t _itemCount;
+  uint8_t _cols;
+  uint8_t _rows;
+  char _marker;
+
+  uint8_t _selected; ///< selected item
+  uint8_t _top; ///< first visible item
+  uint8_t _page; ///< page that shows the menu
+  uint8_t _hiddenPage; ///< page for prefetch() or LCD_MENU_NONE
+  uint8_t _rowItem[2][LCD_MENU_MAXROWS]; ///< items on the pages
+  uint8_t _markerRow[2]; ///< row with the marker on the pages
+
+  const char *_text(uint8_t item);
+  uint8_t _item(uint8_t top, uint8_t row);
+  bool _shows(uint8_t page, uint8_t top, uint8_t selected);
+  bool _render(uint8_t page, uint8_t top, uint8_t selected, bool step);
+  void _sendRow(uint8_t page, uint8_t row, uint8_t item, char first);
+  void _sendMarker(uint8_t page, uint8_t row, char c);
+  void _write(uint8_t page, uint8_t col, uint8_t row, const uint8_t *buffer, uint8_t size);
+};
+
+#endif
@@ -0,0 +1,255 @@
+/// \file LiquidCrystal_PCF8574_Player.cpp
+/// \brief Playback of delta encoded frame sequences on a LiquidCrystal_PCF8574 display.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+/// \copyright Copyright (c) 2019 by Matthias Hertel.
+///
+/// ChangeLog see: LiquidCrystal_PCF8574_Player.h
+
+#include "LiquidCrystal_PCF8574_Player.h"
+
+#define FRAME_HEADER_SIZE 8
+
+#define REC_END 0x00
+#define REC_GLYPH 0x01
+#define REC_RUN 0x02
+
+LiquidCrystal_PCF8574_Player::LiquidCrystal_PCF8574_Player(LiquidCrystal_PCF8574 &lcd, uint8_t *buffer, size_t bufferSize)
+    : _lcd(lcd)
+{
+  _buffer = buffer;
+  _bufferSize = bufferSize;
+  _bufferLen = 0;
+  _prefetched = false;
+  _complete = false;
+  _stream = NULL;
+  _blob = NULL;
+  _blobSize = 0;
+  _blobPos = 0;
+  _cols = 0;
+  _rows = 0;
+  _frameCount = 0;
+  _period = 0;
+  _frame = 0;
+  _lastFrame = 0;
+  _loop = false;
+  _playing = false;
+  _end = false;
+} // LiquidCrystal_PCF8574_Player
+
+
+bool LiquidCrystal_PCF8574_Player::begin(Stream &stream)
+{
+  _stream = &stream;
+  _blob = NULL;
+  return _readHeader();
+} // begin()
+
+
+bool LiquidCrystal_PCF8574_Player::begin(const uint8_t *blob, size_t size)
+{
+  _stream = NULL;
+  _blob = blob;
+  _blobSize = size;
+  _blobPos = 0;
+  return _readHeader();
+} // begin()
+
+
+/// Execute the next frame when the period has elapsed and prefetch the following frame.
+bool LiquidCrystal_PCF8574_Player::update()
+{
+  if (!_playing)
+    return false;
+
+  if (!_prefetched)
+    _prefetch();
+
+  unsigned long now = millis();
+  if ((_frame > 0) && (now - _lastFrame < _period))
+    return true;
+
+  if (_end && (_bufferLen == 0)) {
+    // no more frames
+    if (_loop && _blob) {
+      _blobPos = FRAME_HEADER_SIZE;
+      _end = false;
+      _frame = 0;
+      _prefetched = false;
+      return true;
+    }
+    _playing = false;
+    return false;
+  }
+
+  // keep a fixed frame rate unless we are far behind
+  if ((_frame == 0) || (now - _lastFrame >= 2 * (unsigned long)_period))
+    _lastFrame = now;
+  else
+    _lastFrame += _period;
+
+  size_t pos = 0;
+  while (pos < _bufferLen) {
+    uint8_t *rec = _buffer + pos;
+    _exec(rec);
+    pos += (rec[0] == REC_GLYPH) ? 10 : (3 + rec[2]);
+  }
+  if (!_complete) {
+    while (_execDirect())
+      ;
+  }
+  _frame++;
+
+  // read the next frame while this one is shown
+  _prefetch();
+  return true;
+} // update()
+
+
+int LiquidCrystal_PCF8574_Player::_read()
+{
+  if (_stream)
+    return _stream->read();
+  if (_blob && (_blobPos < _blobSize))
+    return pgm_read_byte(_blob + _blobPos++);
+  return -1;
+} // _read()
+
+
+bool LiquidCrystal_PCF8574_Player::_readHeader()
+{
+  uint8_t h[FRAME_HEADER_SIZE];
+  _playing = false;
+  _end = false;
+  _prefetched = false;
+  _bufferLen = 0;
+  _frame = 0;
+
+  for (uint8_t i = 0; i < FRAME_HEADER_SIZE; i++) {
+    int c = _read();
+    if (c < 0)
+      return false;
+    h[i] = c;
+  }
+  if ((h[0] != 'L') || (h[1] != 'F') || (h[2] == 0) || (h[3] == 0))
+    return false;
+
+  // the sequence must fit on the display
+  if ((h[2] > _lcd.cols()) || (h[3] > _lcd.rows()))
+    return false;
+
+  _cols = h[2];
+  _rows = h[3];
+  _frameCount = h[4] | (h[5] << 8);
+  _period = h[6] | (h[7] << 8);
+
+  // the buffer must hold the largest record
+  if ((_bufferSize < 10) || (_bufferSize < 3 + (size_t)_cols))
+    return false;
+
+  _playing = true;
+  return true;
+} // _readHeader()
+
+
+/// Read complete records of the next frame into the buffer.
+void LiquidCrystal_PCF8574_Player::_prefetch()
+{
+  size_t maxRecord = (3 + _cols > 10) ? 3 + _cols : 10;
+
+  _bufferLen = 0;
+  _complete = false;
+  _prefetched = true;
+
+  while (_bufferSize - _bufferLen >= maxRecord) {
+    int type = _read();
+    if (type < 0) {
+      _end = true;
+      _complete = true;
+      break;
+    } else if (type == REC_END) {
+      _complete = true;
+      break;
+    }
+
+    uint8_t *rec = _buffer + _bufferLen;
+    uint8_t head, len;
+    rec[0] = type;
+    if (type == REC_GLYPH) {
+      head = 1;
+      len = 9; // slot and 8 bytes of the character
+    } else if (type == REC_RUN) {
+      int p = _read();
+      int l = _read();
+      if (!_validRun(p, l)) {
+        _complete = true;
+        break;
+      }
+      rec[1] = p;
+      rec[2] = l;
+      head = 3;
+      len = l;
+    } else {
+      // unknown record: stop the sequence
+      _complete = true;
+      break;
+    }
+
+    for (uint8_t i = 0; i < len; i++) {
+      int c = _read();
+      rec[head + i] = (c < 0) ? ' ' : c;
+    }
+    _bufferLen += head + len;
+  }
+} // _prefetch()
+
+
+/// Execute one record from the buffer.
+void LiquidCrystal_PCF8574_Player::_exec(uint8_t *rec)
+{
+  if (rec[0] == REC_GLYPH) {
+    _lcd.createChar(rec[1], rec + 2);
+  } else if (rec[0] == REC_RUN) {
+    _lcd.writeAt(rec[1] % _cols, rec[1] / _cols, rec + 3, rec[2]);
+  }
+} // _exec()
+
+
+/// Read and execute one record directly from the source.
+/// Returns false at the end of the frame.
+bool LiquidCrystal_PCF8574_Player::_execDirect()
+{
+  int c = _read();
+
+  if (c == REC_GLYPH) {
+    int slot = _read();
+    // the buffer is free after the prefetched records were executed
+    for (uint8_t i = 0; i < 8; i++)
+      _buffer[i] = _read();
+    if (slot >= 0)
+      _lcd.createChar(slot, _buffer);
+    return true;
+
+  } else if (c == REC_RUN) {
+    int p = _read();
+    int l = _read();
+    if (!_validRun(p, l))
+      return false;
+    for (int i = 0; i < l; i++)
+      _buffer[i] = _read();
+    _lcd.writeAt(p % _cols, p / _cols, _buffer, l);
+    return true;
+  }
+  return false;
+} // _execDirect()
+
+
+// A run must be within one row of the sequence, other positions would be folded onto the wrong rows.
+bool LiquidCrystal_PCF8574_Player::_validRun(int pos, int len)
+{
+  if ((pos < 0) || (len < 0) || (pos >= _cols * _rows))
+    return false;
+  return pos % _cols + len <= _cols;
+} // _validRun()
+
+// The End.
@@ -0,0 +1,91 @@
+/// \file LiquidCrystal_PCF8574_Player.h
+/// \brief Playback of delta encoded frame sequences on a LiquidCrystal_PCF8574 display.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+///
+/// \copyright Copyright (c) 2019 by Matthias Hertel.\n
+///
+/// The library work is licensed under a BSD style license.\n
+/// See http://www.mathertel.de/License.aspx
+///
+/// \details
+/// A frame sequence starts with a header followed by the frames.
+/// Every frame only contains the characters that differ from the previous frame
+/// and optional CGRAM definitions. Sequences can be created by extras/frames/lcd_frames.py.
+///
+/// Header (8 bytes):
+///   'L' 'F' cols rows frameCount (uint16 LE) period in msec (uint16 LE)
+///
+/// Frame records:
+///   0x00                           end of frame
+///   0x01 slot b0..b7               define CGRAM character slot (0..7)
+///   0x02 pos len c0..c(len-1)      write len characters at pos = row * cols + col
+///
+/// The player reads the next frame into a buffer while the current frame is displayed
+/// so at the frame time only the bus transfer is done.
+/// Frames that do not fit into the buffer are completed directly from the source.
+/// The first frame of a sequence is written completely so a sequence can be repeated.
+/// begin() refuses a sequence that is larger than the display, so the display must be initialized before.
+/// A run that does not fit into its row stops the frame.
+///
+/// ChangeLog:
+/// --------
+/// * 18.10.2026 created.
+/// * 18.10.2026 Check the size of the sequence and the position of every run.
+
+#ifndef LiquidCrystal_PCF8574_Player_h
+#define LiquidCrystal_PCF8574_Player_h
+
+#include "LiquidCrystal_PCF8574.h"
+
+class LiquidCrystal_PCF8574_Player
+{
+public:
+  LiquidCrystal_PCF8574_Player(LiquidCrystal_PCF8574 &lcd, uint8_t *buffer, size_t bufferSize);
+
+  // start playing a sequence from a stream that is completely available (e.g. a File) or from a blob in PROGMEM.
+  bool begin(Stream &stream);
+  bool begin(const uint8_t *blob, size_t size);
+
+  // restart a PROGMEM sequence at the end instead of stopping.
+  void setLoop(bool loop) { _loop = loop; }
+
+  // call often in loop(). Returns false when the sequence has ended.
+  bool update();
+
+  uint16_t frame() { return _frame; }
+  uint16_t frameCount() { return _frameCount; }
+  uint16_t period() { return _period; }
+
+private:
+  LiquidCrystal_PCF8574 &_lcd;
+  uint8_t *_buffer; ///< buffer for the prefetched frame
+  size_t _bufferSize;
+  size_t _bufferLen; ///< length of the prefetched records
+  bool _prefetched; ///< the next frame is (partly) in the buffer
+  bool _complete; ///< the buffer holds the complete frame
+
+  Stream *_stream;
+  const uint8_t *_blob;
+  size_t _blobSize;
+  size_t _blobPos;
+
+  uint8_t _cols;
+  uint8_t _rows;
+  uint16_t _frameCount;
+  uint16_t _period;
+  uint16_t _frame; ///< number of frames shown
+  unsigned long _lastFrame; ///< time of the last frame
+  bool _loop;
+  bool _playing;
+  bool _end; ///< the end of the source was reached
+
+  int _read();
+  bool _readHeader();
+  void _prefetch();
+  void _exec(uint8_t *record);
+  bool _execDirect();
+  bool _validRun(int pos, int len);
+};
+
+#endif
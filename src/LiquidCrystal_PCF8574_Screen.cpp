@@ -0,0 +1,402 @@
+/// \file LiquidCrystal_PCF8574_Screen.cpp
+/// \brief Screen templates with data bound fields for LiquidCrystal_PCF8574 displays.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+/// \copyright Copyright (c) 2019 by Matthias Hertel.
+///
+/// ChangeLog see: LiquidCrystal_PCF8574_Screen.h
+
+#include "LiquidCrystal_PCF8574_Screen.h"
+
+#include <limits.h>
+
+LiquidCrystal_PCF8574_Screen::LiquidCrystal_PCF8574_Screen(LiquidCrystal_PCF8574 &lcd, const char *layout,
+    const LiquidCrystal_PCF8574_Field *fields, uint8_t fieldCount, char *cache, size_t cacheSize)
+    : _lcd(lcd)
+{
+  LiquidCrystal_PCF8574_Field field;
+  size_t used = 0;
+
+  _layout = layout;
+  _fields = fields;
+  _cache = cache;
+
+  // only the fields that fit into the cache are used
+  _fieldCount = 0;
+  while (_fieldCount < fieldCount) {
+    _getField(_fieldCount, &field);
+    if (used + field.width > cacheSize)
+      break;
+    used += field.width;
+    _fieldCount++;
+  }
+  _stats = NULL;
+  _oldest = 0;
+} // LiquidCrystal_PCF8574_Screen
+
+
+/// Send the static text row by row in chunks of one Wire transmission and then all fields.
+void LiquidCrystal_PCF8574_Screen::draw()
+{
+  uint8_t chunk[LCD_CHARS_PER_TRANSMISSION];
+  uint8_t len = 0;
+  uint8_t col = 0;
+  uint8_t row = 0;
+  const char *p = _layout;
+
+  for (;;) {
+    char c = p ? pgm_read_byte(p++) : '\0';
+    if ((c == '\0') || (c == '\n') || (len == sizeof(chunk))) {
+      if (len) _lcd.writeAt(col, row, chunk, len);
+      col += len;
+      len = 0;
+    }
+    if (c == '\0')
+      break;
+    if (c == '\n') {
+      col = 0;
+      row++;
+    } else {
+      chunk[len++] = c;
+    }
+  }
+
+  // all fields are sent completely
+  LiquidCrystal_PCF8574_Field field;
+  char *cache = _cache;
+  for (uint8_t n = 0; n < _fieldCount; n++) {
+    _getField(n, &field);
+    _format(&field, cache);
+    _lcd.writeAt(field.col, field.row, (const uint8_t *)cache, field.width);
+    cache += field.width;
+  }
+} // draw()
+
+
+void LiquidCrystal_PCF8574_Screen::refresh(uint16_t budget)
+{
+  LiquidCrystal_PCF8574_Field field;
+  char text[LCD_FIELD_MAXWIDTH];
+  char *cache = _cache;
+  uint16_t used = 0;
+
+  if (budget && _stats) {
+    _refreshOldestFirst(budget);
+    return;
+  }
+
+  for (uint8_t n = 0; n < _fieldCount; n++) {
+    unsigned long start = micros();
+    _getField(n, &field);
+    _format(&field, text);
+    if (budget) {
+      uint8_t cost = _countChanges(&field, text, cache);
+      // the first change is sent even when it is larger than the budget so it cannot block the other fields
+      if ((used > 0) && (used + cost > budget)) {
+        cache += field.width;
+        continue;
+      }
+      used += cost;
+    }
+    bool sent = _sendChanges(&field, text, cache);
+    if (_stats)
+      _record(n, sent, start);
+    cache += field.width;
+  }
+} // refresh()
+
+
+/// Send changed fields ordered by the age of the change, weighted by the priority of the field,
+/// until the budget of characters is used. Fields that do not fit into the rest of the budget are skipped,
+/// the most urgent field is always sent.
+void LiquidCrystal_PCF8574_Screen::_refreshOldestFirst(uint16_t budget)
+{
+  LiquidCrystal_PCF8574_Field field;
+  char text[LCD_FIELD_MAXWIDTH];
+  char *cache = _cache;
+  unsigned long now = micros();
+  uint16_t used = 0;
+  uint8_t last = 0xFF; // the field that was tried before
+  unsigned long lastScore = 0;
+
+  // find the fields that have changed since the last transmission
+  for (uint8_t n = 0; n < _fieldCount; n++) {
+    _getField(n, &field);
+    _format(&field, text);
+    if (memcmp(text, cache, field.width) != 0) {
+      if (!_stats[n].pending) {
+        _stats[n].pending = true;
+        _stats[n].stamp = now;
+      }
+    } else if (_stats[n].pending) {
+      // the display already shows the value
+      _record(n, false, now);
+    }
+    cache += field.width;
+  }
+
+  while (used < budget) {
+    // the most urgent field after the one tried before: by descending score, equal scores by index
+    uint8_t next = 0xFF;
+    unsigned long best = 0;
+    for (uint8_t n = 0; n < _fieldCount; n++) {
+      if (!_stats[n].pending)
+        continue;
+      unsigned long score = _score(n, now);
+      if ((last != 0xFF) && ((score > lastScore) || ((score == lastScore) && (n <= last))))
+        continue;
+      if ((next == 0xFF) || (score > best)) {
+        next = n;
+        best = score;
+      }
+    }
+    if (next == 0xFF)
+      break;
+    last = next;
+    lastScore = best;
+
+    _getField(next, &field);
+    cache = _cacheOf(next);
+    _format(&field, text);
+    uint8_t cost = _countChanges(&field, text, cache);
+    if ((used > 0) && (used + cost > budget))
+      continue;
+    bool sent = _sendChanges(&field, text, cache);
+    _record(next, sent, now);
+    used += cost;
+  }
+
+  // age of the oldest change that is not on the display
+  _oldest = 0;
+  now = micros();
+  for (uint8_t n = 0; n < _fieldCount; n++) {
+    if (_stats[n].pending && (now - _stats[n].stamp > _oldest))
+      _oldest = now - _stats[n].stamp;
+  }
+} // _refreshOldestFirst()
+
+
+// The age of a pending change weighted by the priority of the field, saturated instead of overflowing.
+unsigned long LiquidCrystal_PCF8574_Screen::_score(uint8_t n, unsigned long now)
+{
+  LiquidCrystal_PCF8574_Field field;
+  _getField(n, &field);
+  unsigned long age = now - _stats[n].stamp;
+  unsigned long weight = 1 + field.priority;
+  if (age > ULONG_MAX / weight)
+    return ULONG_MAX;
+  return age * weight;
+} // _score()
+
+
+char *LiquidCrystal_PCF8574_Screen::_cacheOf(uint8_t n)
+{
+  LiquidCrystal_PCF8574_Field field;
+  char *cache = _cache;
+  for (uint8_t i = 0; i < n; i++) {
+    _getField(i, &field);
+    cache += field.width;
+  }
+  return cache;
+} // _cacheOf()
+
+
+/// Number of characters that are sent for a field, including gaps within a run.
+uint8_t LiquidCrystal_PCF8574_Screen::_countChanges(LiquidCrystal_PCF8574_Field *field, const char *text, const char *cache)
+{
+  int8_t first = -1;
+  uint8_t last = 0;
+  for (uint8_t i = 0; i < field->width; i++) {
+    if (text[i] != cache[i]) {
+      if (first < 0)
+        first = i;
+      last = i;
+    }
+  }
+  return (first < 0) ? 0 : last - first + 1;
+} // _countChanges()
+
+
+void LiquidCrystal_PCF8574_Screen::setLatencyStats(LiquidCrystal_PCF8574_Latency *stats)
+{
+  _stats = stats;
+  resetLatency();
+} // setLatencyStats()
+
+
+void LiquidCrystal_PCF8574_Screen::changed(uint8_t field)
+{
+  if (_stats && (field < _fieldCount) && !_stats[field].pending) {
+    _stats[field].pending = true;
+    _stats[field].stamp = micros();
+  }
+} // changed()
+
+
+unsigned long LiquidCrystal_PCF8574_Screen::latencyMax(uint8_t field)
+{
+  if (!_stats || (field >= _fieldCount))
+    return 0;
+  return _stats[field].max;
+} // latencyMax()
+
+
+unsigned long LiquidCrystal_PCF8574_Screen::latencyPercentile(uint8_t field, uint8_t percent)
+{
+  if (!_stats || (field >= _fieldCount))
+    return 0;
+
+  uint16_t *histogram = _stats[field].histogram;
+  unsigned long total = 0;
+  for (uint8_t b = 0; b < LCD_LATENCY_BUCKETS; b++)
+    total += histogram[b];
+  if (total == 0)
+    return 0;
+
+  unsigned long sum = 0;
+  unsigned long limit = 500;
+  for (uint8_t b = 0; b < LCD_LATENCY_BUCKETS - 1; b++) {
+    sum += histogram[b];
+    if (sum * 100 >= total * percent)
+      return (limit < _stats[field].max) ? limit : _stats[field].max;
+    limit *= 2;
+  }
+  // the last bucket is open, the maximum is the best bound
+  return _stats[field].max;
+} // latencyPercentile()
+
+
+void LiquidCrystal_PCF8574_Screen::resetLatency()
+{
+  if (_stats)
+    memset(_stats, 0, _fieldCount * sizeof(LiquidCrystal_PCF8574_Latency));
+} // resetLatency()
+
+
+/// Record the latency of a field after its changes were sent.
+void LiquidCrystal_PCF8574_Screen::_record(uint8_t n, bool sent, unsigned long start)
+{
+  LiquidCrystal_PCF8574_Latency *s = _stats + n;
+  unsigned long now = micros();
+
+  if (!s->pending) {
+    if (!sent)
+      return;
+    // the change was found by refresh()
+    s->stamp = start;
+  }
+  unsigned long latency = now - s->stamp;
+  s->pending = false;
+
+  if (latency > s->max)
+    s->max = latency;
+
+  uint8_t b = 0;
+  unsigned long limit = 500;
+  while ((b < LCD_LATENCY_BUCKETS - 1) && (latency >= limit)) {
+    b++;
+    limit *= 2;
+  }
+  if (s->histogram[b] < 0xFFFF)
+    s->histogram[b]++;
+} // _record()
+
+
+void LiquidCrystal_PCF8574_Screen::_getField(uint8_t n, LiquidCrystal_PCF8574_Field *field)
+{
+  memcpy_P(field, _fields + n, sizeof(LiquidCrystal_PCF8574_Field));
+  if (field->width > LCD_FIELD_MAXWIDTH)
+    field->width = LCD_FIELD_MAXWIDTH;
+} // _getField()
+
+
+/// Format the bound value into exactly width characters.
+void LiquidCrystal_PCF8574_Screen::_format(LiquidCrystal_PCF8574_Field *field, char *buffer)
+{
+  uint8_t width = field->width;
+  long v;
+
+  memset(buffer, ' ', width);
+
+  switch (field->type) {
+  case LCD_FIELD_INT:
+    v = *(const int *)field->value;
+    break;
+  case LCD_FIELD_LONG:
+    v = *(const long *)field->value;
+    break;
+  case LCD_FIELD_BYTE:
+    v = *(const uint8_t *)field->value;
+    break;
+  case LCD_FIELD_STRING: {
+    const char *s = (const char *)field->value;
+    for (uint8_t i = 0; (i < width) && s[i]; i++)
+      buffer[i] = s[i];
+    return;
+  }
+  case LCD_FIELD_CALLBACK:
+    ((LiquidCrystal_PCF8574_FieldCallback)field->value)(buffer, width);
+    return;
+  default:
+    return;
+  }
+
+  // right aligned number with optional fixed decimals
+  bool negative = (v < 0);
+  unsigned long u = negative ? -(unsigned long)v : v;
+  int8_t i = width - 1;
+  uint8_t digits = 0;
+
+  do {
+    if ((field->decimals > 0) && (digits == field->decimals) && (i >= 0))
+      buffer[i--] = '.';
+    if (i < 0)
+      break;
+    buffer[i--] = '0' + (u % 10);
+    u /= 10;
+    digits++;
+  } while ((u > 0) || (digits <= field->decimals));
+
+  if (negative) {
+    if (i >= 0)
+      buffer[i--] = '-';
+    else
+      u = 1;
+  }
+  if (u > 0) {
+    // does not fit
+    memset(buffer, '#', width);
+  }
+} // _format()
+
+
+/// Send the runs of characters that differ from the cache. Returns true when characters were sent.
+/// Unchanged gaps of one character are sent within the run as this is cheaper than a setCursor().
+bool LiquidCrystal_PCF8574_Screen::_sendChanges(LiquidCrystal_PCF8574_Field *field, const char *text, char *cache)
+{
+  uint8_t width = field->width;
+  uint8_t i = 0;
+  bool sent = false;
+
+  while (i < width) {
+    if (text[i] == cache[i]) {
+      i++;
+      continue;
+    }
+    uint8_t start = i;
+    uint8_t end = i;
+    while (i < width) {
+      if (text[i] != cache[i])
+        end = i;
+      else if (i - end > 1)
+        break;
+      i++;
+    }
+    _lcd.writeAt(field->col + start, field->row, (const uint8_t *)text + start, end - start + 1);
+    memcpy(cache + start, text + start, end - start + 1);
+    sent = true;
+  }
+  return sent;
+} // _sendChanges()
+
+// The End.
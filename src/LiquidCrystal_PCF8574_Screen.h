@@ -0,0 +1,136 @@
+/// \file LiquidCrystal_PCF8574_Screen.h
+/// \brief Screen templates with data bound fields for LiquidCrystal_PCF8574 displays.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+///
+/// \copyright Copyright (c) 2019 by Matthias Hertel.\n
+///
+/// The library work is licensed under a BSD style license.\n
+/// See http://www.mathertel.de/License.aspx
+///
+/// \details
+/// A screen is a static layout text and a list of fields, both in PROGMEM.
+/// Every field is bound to a variable by a pointer or to a callback that formats the value.
+/// draw() sends the static text and all fields,
+/// refresh() formats the fields and only sends the characters that have changed.
+///
+/// The text that is on the display for the fields is kept in a cache buffer
+/// that is provided by the application with its size and should hold the sum of all field widths.
+/// Fields that do not fit into the cache anymore are not shown, see fieldCount().
+///
+/// Example:
+///   int temp;
+///   const char layout[] PROGMEM = "Temp:      C\n";
+///   const LiquidCrystal_PCF8574_Field fields[] PROGMEM = {
+///     { 6, 0, 5, LCD_FIELD_INT, 1, &temp, 0 } // 123 is shown as " 12.3", priority 0
+///   };
+///   char cache[5];
+///   LiquidCrystal_PCF8574_Screen screen(lcd, layout, fields, 1, cache, sizeof(cache));
+///
+/// The latency from a change of a value to the end of the transmission that shows it
+/// can be recorded per field, see setLatencyStats().
+///
+/// ChangeLog:
+/// --------
+/// * 18.10.2026 created.
+/// * 18.10.2026 latency statistics per field.
+/// * 18.10.2026 refresh with a budget sends the oldest changes first.
+/// * 18.10.2026 the size of the cache is passed to the constructor.
+/// * 18.10.2026 a change larger than the budget does not block the other fields.
+/// * 18.10.2026 draw() sends the layout in chunks of one Wire transmission.
+
+#ifndef LiquidCrystal_PCF8574_Screen_h
+#define LiquidCrystal_PCF8574_Screen_h
+
+#include "LiquidCrystal_PCF8574.h"
+
+#define LCD_FIELD_MAXWIDTH 40 ///< a field must fit into one line of the display RAM
+
+/// kind of the bound value
+enum LiquidCrystal_PCF8574_FieldType {
+  LCD_FIELD_INT, ///< int *, right aligned
+  LCD_FIELD_LONG, ///< long *, right aligned
+  LCD_FIELD_BYTE, ///< uint8_t *, right aligned
+  LCD_FIELD_STRING, ///< const char * in RAM, left aligned
+  LCD_FIELD_CALLBACK ///< LiquidCrystal_PCF8574_FieldCallback
+};
+
+/// format a value into buffer, exactly width characters.
+typedef void (*LiquidCrystal_PCF8574_FieldCallback)(char *buffer, uint8_t width);
+
+/// description of a field, typically stored in PROGMEM.
+struct LiquidCrystal_PCF8574_Field {
+  uint8_t col;
+  uint8_t row;
+  uint8_t width;
+  uint8_t type; ///< LiquidCrystal_PCF8574_FieldType
+  uint8_t decimals; ///< fixed point digits for numbers
+  const void *value; ///< pointer to the variable or the callback
+  uint8_t priority; ///< 0..n, a change of priority p counts as (p+1) times as old when the budget is limited
+};
+
+#define LCD_LATENCY_BUCKETS 10 ///< buckets of 0.5, 1, 2, ... 128 msec and more
+
+/// latency statistics of a field.
+struct LiquidCrystal_PCF8574_Latency {
+  bool pending; ///< a change is not yet on the display
+  unsigned long stamp; ///< micros() of the pending change
+  unsigned long max; ///< maximum latency in microseconds
+  uint16_t histogram[LCD_LATENCY_BUCKETS];
+};
+
+class LiquidCrystal_PCF8574_Screen
+{
+public:
+  LiquidCrystal_PCF8574_Screen(LiquidCrystal_PCF8574 &lcd, const char *layout,
+    const LiquidCrystal_PCF8574_Field *fields, uint8_t fieldCount, char *cache, size_t cacheSize);
+
+  // send the static text and all fields. The display is not cleared.
+  void draw();
+
+  // send the characters of fields that have changed.
+  // With a budget at most about budget characters are sent. With latency statistics the oldest
+  // changes are sent first, weighted by the priority of the field, otherwise from the top left.
+  // Fields that do not fit into the rest of the budget are skipped, the first field is always sent.
+  void refresh(uint16_t budget = 0);
+
+  // age in microseconds of the oldest change that was not sent by the last refresh() with budget.
+  unsigned long oldestPending() { return _oldest; }
+
+  // the number of fields that are shown: the first ones that fit into the cache.
+  uint8_t fieldCount() { return _fieldCount; }
+
+  // record the latency of every field into stats, an array with one entry per field.
+  void setLatencyStats(LiquidCrystal_PCF8574_Latency *stats);
+
+  // the value of a field was written. Without this call the time of a change is the time refresh() finds it.
+  void changed(uint8_t field);
+
+  // maximum latency of a field in microseconds.
+  unsigned long latencyMax(uint8_t field);
+
+  // upper bound of the latency in microseconds that percent of the updates of a field met.
+  unsigned long latencyPercentile(uint8_t field, uint8_t percent);
+
+  void resetLatency();
+
+private:
+  LiquidCrystal_PCF8574 &_lcd;
+  const char *_layout; ///< static text in PROGMEM, rows separated by '\n'
+  const LiquidCrystal_PCF8574_Field *_fields; ///< fields in PROGMEM
+  uint8_t _fieldCount;
+  char *_cache; ///< the field texts on the display
+  LiquidCrystal_PCF8574_Latency *_stats; ///< optional latency statistics
+  unsigned long _oldest; ///< age of the oldest pending change
+
+  void _getField(uint8_t n, LiquidCrystal_PCF8574_Field *field);
+  void _format(LiquidCrystal_PCF8574_Field *field, char *buffer);
+  void _refreshOldestFirst(uint16_t budget);
+  unsigned long _score(uint8_t n, unsigned long now);
+  char *_cacheOf(uint8_t n);
+  uint8_t _countChanges(LiquidCrystal_PCF8574_Field *field, const char *text, const char *cache);
+  bool _sendChanges(LiquidCrystal_PCF8574_Field *field, const char *text, char *cache);
+  void _record(uint8_t n, bool sent, unsigned long start);
+};
+
+#endif
@@ -0,0 +1,142 @@
+/// \file LiquidCrystal_PCF8574_Static.h
+/// \brief Variants of the buffered classes with storage that is sized and checked at compile time.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+///
+/// \copyright Copyright (c) 2019 by Matthias Hertel.\n
+///
+/// The library work is licensed under a BSD style license.\n
+/// See http://www.mathertel.de/License.aspx
+///
+/// \details
+/// The buffered classes of the library work on storage that is passed to the constructor,
+/// and a buffer that is too small is only noticed at runtime (e.g. the Player then reads frames directly from the source,
+/// the Menu shows only the first 4 rows). The templates in this file contain the storage for a given geometry
+/// and refuse to compile when the geometry or a size is not supported.
+/// Declared as global variables the storage is part of the static RAM reported by the compiler, no heap is used.
+///
+/// Example:
+///   LiquidCrystal_PCF8574_StaticScreen<4, 18, true> screen(lcd, layout, fields); // 4 fields with 18 characters, latency stats
+///   LiquidCrystal_PCF8574_StaticMenu<16, 2> menu(lcd, items, 5);
+///   LiquidCrystal_PCF8574_StaticPlayer<64, 16> player(lcd);
+///
+/// ChangeLog:
+/// --------
+/// * 18.10.2026 created.
+/// * 18.10.2026 the geometry of StaticExchange is checked also when its constructor is not used.
+
+#ifndef LiquidCrystal_PCF8574_Static_h
+#define LiquidCrystal_PCF8574_Static_h
+
+#include "LiquidCrystal_PCF8574.h"
+#include "LiquidCrystal_PCF8574_Player.h"
+#include "LiquidCrystal_PCF8574_Screen.h"
+#include "LiquidCrystal_PCF8574_Menu.h"
+#include "LiquidCrystal_PCF8574_Glyphs.h"
+#include "LiquidCrystal_PCF8574_Exchange.h"
+
+/// Display geometries the HD44780 supports: up to 80 characters, one display RAM line has 40.
+template <uint8_t COLS, uint8_t ROWS>
+struct LiquidCrystal_PCF8574_Geometry {
+  static_assert((COLS > 0) && (COLS <= 40), "a display has 1 to 40 columns");
+  static_assert((ROWS > 0) && (ROWS <= 4), "a display has 1 to 4 rows");
+  static_assert(COLS * ROWS <= 80, "a display has at most 80 characters");
+  static const uint8_t cols = COLS;
+  static const uint8_t rows = ROWS;
+};
+
+
+/// Storage that is initialized before the class that uses it (base from member).
+template <typename T, size_t N>
+struct LiquidCrystal_PCF8574_Storage {
+  T _storage[N];
+};
+
+template <typename T>
+struct LiquidCrystal_PCF8574_Storage<T, 0> {
+  T *_storage = NULL;
+};
+
+
+/// Player with a prefetch buffer of SIZE bytes for sequences with COLS columns.
+/// The buffer must hold a CGRAM record and a complete row.
+template <size_t SIZE, uint8_t COLS>
+class LiquidCrystal_PCF8574_StaticPlayer : private LiquidCrystal_PCF8574_Storage<uint8_t, SIZE>, public LiquidCrystal_PCF8574_Player
+{
+  static_assert(SIZE >= 10, "the buffer must hold a CGRAM record (10 bytes)");
+  static_assert(SIZE >= 3 + (size_t)LiquidCrystal_PCF8574_Geometry<COLS, 1>::cols, "the buffer must hold a row record");
+
+public:
+  LiquidCrystal_PCF8574_StaticPlayer(LiquidCrystal_PCF8574 &lcd)
+      : LiquidCrystal_PCF8574_Player(lcd, this->_storage, SIZE) {}
+};
+
+
+/// Screen with FIELDS fields and CACHE characters, the sum of the field widths.
+/// With STATS the latency statistics of every field are recorded.
+template <uint8_t FIELDS, uint16_t CACHE, bool STATS = false>
+class LiquidCrystal_PCF8574_StaticScreen : private LiquidCrystal_PCF8574_Storage<char, CACHE>,
+                                           private LiquidCrystal_PCF8574_Storage<LiquidCrystal_PCF8574_Latency, STATS ? FIELDS : 0>,
+                                           public LiquidCrystal_PCF8574_Screen
+{
+  typedef LiquidCrystal_PCF8574_Storage<char, CACHE> Cache;
+  typedef LiquidCrystal_PCF8574_Storage<LiquidCrystal_PCF8574_Latency, STATS ? FIELDS : 0> Stats;
+  static_assert(FIELDS > 0, "a screen has at least one field");
+  static_assert(CACHE >= FIELDS, "every field is at least one character wide");
+  static_assert(CACHE <= (uint16_t)FIELDS * LCD_FIELD_MAXWIDTH, "a field is at most LCD_FIELD_MAXWIDTH characters wide");
+
+public:
+  // the number of fields must match FIELDS.
+  LiquidCrystal_PCF8574_StaticScreen(LiquidCrystal_PCF8574 &lcd, const char *layout, const LiquidCrystal_PCF8574_Field (&fields)[FIELDS])
+      : LiquidCrystal_PCF8574_Screen(lcd, layout, fields, FIELDS, Cache::_storage, CACHE)
+  {
+    if (STATS)
+      setLatencyStats(Stats::_storage);
+  }
+};
+
+
+/// Menu for a display with COLS columns and ROWS rows.
+template <uint8_t COLS, uint8_t ROWS>
+class LiquidCrystal_PCF8574_StaticMenu : public LiquidCrystal_PCF8574_Menu
+{
+  static_assert(LiquidCrystal_PCF8574_Geometry<COLS, ROWS>::rows <= LCD_MENU_MAXROWS, "more rows than LCD_MENU_MAXROWS");
+
+public:
+  LiquidCrystal_PCF8574_StaticMenu(LiquidCrystal_PCF8574 &lcd, const char *const *items, uint8_t itemCount, char marker = '>')
+      : LiquidCrystal_PCF8574_Menu(lcd, items, itemCount, COLS, ROWS, marker) {}
+};
+
+
+/// Glyph management for a PROGMEM table with GLYPHS entries.
+template <uint8_t GLYPHS>
+class LiquidCrystal_PCF8574_StaticGlyphs : public LiquidCrystal_PCF8574_Glyphs
+{
+  static_assert(GLYPHS < LCD_GLYPH_NONE, "glyph indexes must be smaller than LCD_GLYPH_NONE");
+
+public:
+  // the size of the table must match GLYPHS.
+  LiquidCrystal_PCF8574_StaticGlyphs(LiquidCrystal_PCF8574 &lcd, const uint8_t (&glyphs)[GLYPHS][8])
+      : LiquidCrystal_PCF8574_Glyphs(lcd, glyphs, GLYPHS) {}
+};
+
+
+#if !defined(__AVR__)
+
+/// Frame exchange for a display with COLS columns and ROWS rows.
+template <uint8_t COLS, uint8_t ROWS>
+class LiquidCrystal_PCF8574_StaticExchange : private LiquidCrystal_PCF8574_Storage<uint8_t, LCD_EXCHANGE_SIZE(COLS, ROWS)>,
+                                             public LiquidCrystal_PCF8574_Exchange
+{
+  typedef LiquidCrystal_PCF8574_Geometry<COLS, ROWS> Geometry;
+  // instantiates the checks of the geometry, a typedef alone does not
+  static_assert(LCD_EXCHANGE_SIZE(Geometry::cols, Geometry::rows) > 0, "the frames need storage");
+
+public:
+  LiquidCrystal_PCF8574_StaticExchange(LiquidCrystal_PCF8574 &lcd)
+      : LiquidCrystal_PCF8574_Exchange(lcd, Geometry::cols, Geometry::rows, this->_storage) {}
+};
+
+#endif
+
+#endif
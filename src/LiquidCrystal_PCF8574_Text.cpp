@@ -0,0 +1,124 @@
+/// \file LiquidCrystal_PCF8574_Text.cpp
+/// \brief Compressed strings and screens in PROGMEM for LiquidCrystal_PCF8574 displays.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+/// \copyright Copyright (c) 2019 by Matthias Hertel.
+///
+/// ChangeLog see: LiquidCrystal_PCF8574_Text.h
+
+#include "LiquidCrystal_PCF8574_Text.h"
+
+#define TOKEN_LITERAL 0x00
+#define TOKEN_RUN 0x01
+#define TOKEN_DICT 0x80
+
+LiquidCrystal_PCF8574_Text::LiquidCrystal_PCF8574_Text(const uint8_t *blob)
+{
+  _blob = blob;
+  _pos = NULL;
+  _dictPos = NULL;
+  _dictLen = 0;
+  _runLen = 0;
+  _runChar = 0;
+  _remaining = 0;
+} // LiquidCrystal_PCF8574_Text
+
+
+uint16_t LiquidCrystal_PCF8574_Text::count()
+{
+  return _word(_blob);
+} // count()
+
+
+bool LiquidCrystal_PCF8574_Text::open(uint16_t index)
+{
+  _dictLen = 0;
+  _runLen = 0;
+  _remaining = 0;
+  if (index >= count())
+    return false;
+
+  _pos = _blob + _word(_blob + 4 + 2 * index);
+  _remaining = pgm_read_byte(_pos++);
+  return true;
+} // open()
+
+
+size_t LiquidCrystal_PCF8574_Text::show(LiquidCrystal_PCF8574 &lcd, uint16_t index)
+{
+  if (!open(index))
+    return 0;
+  return lcd.pumpFrom(*this, _remaining, true);
+} // show()
+
+
+int LiquidCrystal_PCF8574_Text::available()
+{
+  return _remaining;
+} // available()
+
+
+/// Decode the next character of the string.
+int LiquidCrystal_PCF8574_Text::read()
+{
+  while (_remaining) {
+    if (_runLen) {
+      _runLen--;
+      _remaining--;
+      return _runChar;
+    }
+    if (_dictLen) {
+      _dictLen--;
+      _remaining--;
+      return pgm_read_byte(_dictPos++);
+    }
+
+    uint8_t t = pgm_read_byte(_pos++);
+    if (t == TOKEN_LITERAL) {
+      _remaining--;
+      return pgm_read_byte(_pos++);
+
+    } else if (t == TOKEN_RUN) {
+      _runLen = pgm_read_byte(_pos++);
+      _runChar = pgm_read_byte(_pos++);
+
+    } else if (t >= TOKEN_DICT) {
+      const uint8_t *dict = _blob + _word(_blob + 2);
+      _dictPos = _blob + _word(dict + 1 + 2 * (t - TOKEN_DICT));
+      _dictLen = pgm_read_byte(_dictPos++);
+
+    } else {
+      _remaining--;
+      return t;
+    }
+  }
+  return -1;
+} // read()
+
+
+int LiquidCrystal_PCF8574_Text::peek()
+{
+  // decode one character and restore the state
+  const uint8_t *pos = _pos;
+  const uint8_t *dictPos = _dictPos;
+  uint8_t dictLen = _dictLen;
+  uint8_t runLen = _runLen;
+  uint8_t remaining = _remaining;
+
+  int c = read();
+
+  _pos = pos;
+  _dictPos = dictPos;
+  _dictLen = dictLen;
+  _runLen = runLen;
+  _remaining = remaining;
+  return c;
+} // peek()
+
+
+uint16_t LiquidCrystal_PCF8574_Text::_word(const uint8_t *p)
+{
+  return pgm_read_byte(p) | (pgm_read_byte(p + 1) << 8);
+} // _word()
+
+// The End.
@@ -0,0 +1,69 @@
+/// \file LiquidCrystal_PCF8574_Text.h
+/// \brief Compressed strings and screens in PROGMEM for LiquidCrystal_PCF8574 displays.
+///
+/// \author Matthias Hertel, http://www.mathertel.de
+///
+/// \copyright Copyright (c) 2019 by Matthias Hertel.\n
+///
+/// The library work is licensed under a BSD style license.\n
+/// See http://www.mathertel.de/License.aspx
+///
+/// \details
+/// The text store is a blob in PROGMEM that is created by extras/text/lcd_text.py.
+/// Strings are compressed with run-length coding and a dictionary of shared substrings.
+/// The class is a Stream that decodes one string at a time without a decompression buffer,
+/// so it can be passed to LiquidCrystal_PCF8574::pumpFrom() to send it in chunks.
+///
+/// Blob layout (all numbers uint16 LE):
+///   count, dictionary offset, offsets of the strings
+///   per string: decoded length (uint8), tokens
+///   dictionary: entry count (uint8), offsets of the entries, per entry: length (uint8), bytes
+///
+/// Tokens:
+///   0x00 c          literal c
+///   0x01 n c        n times the character c
+///   0x02..0x7F      literal character
+///   0x80..0xFF      dictionary entry (token - 0x80)
+///
+/// ChangeLog:
+/// --------
+/// * 18.10.2026 created.
+
+#ifndef LiquidCrystal_PCF8574_Text_h
+#define LiquidCrystal_PCF8574_Text_h
+
+#include "LiquidCrystal_PCF8574.h"
+
+class LiquidCrystal_PCF8574_Text : public Stream
+{
+public:
+  LiquidCrystal_PCF8574_Text(const uint8_t *blob);
+
+  // number of strings in the store
+  uint16_t count();
+
+  // start reading the string with the given index
+  bool open(uint16_t index);
+
+  // print the string with the given index at the cursor position. '\n' starts the next row.
+  size_t show(LiquidCrystal_PCF8574 &lcd, uint16_t index);
+
+  // support of Stream class
+  virtual int available();
+  virtual int read();
+  virtual int peek();
+  virtual size_t write(uint8_t) { return 0; }
+
+private:
+  const uint8_t *_blob; ///< the blob in PROGMEM
+  const uint8_t *_pos; ///< next token
+  const uint8_t *_dictPos; ///< next byte of the current dictionary entry
+  uint8_t _dictLen; ///< remaining bytes of the current dictionary entry
+  uint8_t _runLen; ///< remaining characters of the current run
+  uint8_t _runChar;
+  uint8_t _remaining; ///< remaining characters of the string
+
+  uint16_t _word(const uint8_t *p);
+};
+
+#endif